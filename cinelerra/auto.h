@@ -40,7 +40,7 @@ class Auto : public ListItem<Auto>
 public:
 	Auto();
 	Auto(EDL *edl, Autos *autos);
-	virtual ~Auto() {};
+	virtual ~Auto();
 
 	virtual Auto& operator=(Auto &that);
 	virtual int operator==(Auto &that);
@@ -55,6 +55,10 @@ public:
 	Auto* get_prev_auto(int64_t position, int direction, Auto* &current, int use_default = 1);
 	Auto* get_prev_auto(int direction, Auto* &current);
 	Auto* get_next_auto(int64_t position, int direction, Auto* &current, int use_default = 1);
+// Get last auto on or before position or 0 by binary search of the index.
+	Auto* search_index(int64_t position);
+// Called when an auto is deleted.  The index is rebuilt on the next search.
+	void invalidate_index();
 // Determine if a keyframe exists before creating it.
 	int auto_exists_for_editing(double position);
 // Returns auto at exact position, null if non-existent. ignores autokeyframming and align on frames
@@ -184,6 +188,16 @@ public:
 	int virtual_center;
 	int stack_number;
 	int stack_total;
+
+private:
+	void update_index();
+	int search_index(int64_t position, int verify, Auto **result);
+
+// Autos in ascending position order for searching without a starting point.
+// Autos inserted or moved after the index was built are detected by checking
+// the neighbors of the result in the list.
+	ArrayList<Auto*> index;
+	int index_valid;
 };
 
 
@@ -35,6 +35,7 @@
 #include "arraylist.h"
 #include "asset.inc"
 #include "cache.inc"
+#include "cachebudget.h"
 #include "condition.inc"
 #include "edl.inc"
 #include "file.inc"
@@ -63,11 +64,12 @@ private:
 	CICache *cache;
 };
 
-class CICache : public List<CICacheItem>
+class CICache : public List<CICacheItem>, public CacheAccount
 {
 public:
 	CICache(Preferences *preferences,
-		ArrayList<PluginServer*> *plugindb);
+		ArrayList<PluginServer*> *plugindb,
+		const char *title = "CICache");
 	~CICache();
 
 	friend class CICacheItem;
@@ -97,6 +99,11 @@ public:
 // Called by MWindow::age_caches.
 	int get_oldest();
 	int64_t get_memory_usage(int use_lock);
+	int64_t get_memory_usage();
+// A check_out finding an open file is a hit.
+	void get_statistics(int64_t *hits, 
+		int64_t *misses, 
+		int64_t *evictions);
 
 // Called by age() and MWindow::age_caches
 // returns 1 if nothing was available to delete
@@ -126,6 +133,9 @@ private:
 // Copy of EDL
 	EDL *edl;
 	Preferences *preferences;
+	int64_t hits;
+	int64_t misses;
+	int64_t evictions;
 };
 
 
@@ -24,6 +24,7 @@
 
 
 #include "asset.inc"
+#include "cachebudget.h"
 #include "linklist.h"
 #include "mutex.inc"
 #include <stdint.h>
@@ -33,7 +34,19 @@
 // Drawing caches must be separate from file caches to avoid
 // delaying other file accesses for the drawing routines.
 
+// Items are spread over CACHE_SHARDS shards by a hash of the position.
+// Each shard has its own lock, a hash table of bucket chains for lookup
+// and a list in ascending age order for eviction, so lookup, insertion and
+// deletion of the oldest item don't depend on the size of the cache.
 
+// Number of independently locked shards.  Must be a power of 2.
+#define CACHE_SHARDS 16
+// Initial number of hash buckets in each shard.  Must be a power of 2.
+#define CACHE_BUCKETS 256
+
+class CacheShard;
+
+// The ListItem links are the age order of the shard the item is in.
 class CacheItemBase : public ListItem<CacheItemBase>
 {
 public:
@@ -54,14 +67,46 @@ public:
 	int age;
 // Starting point of item in asset's native rate.
 	int64_t position;
+
+// Next item in the same hash bucket
+	CacheItemBase *hash_next;
+// Size when the item was put in the cache.
+	int64_t size;
 };
 
 
 
-class CacheBase : public List<CacheItemBase>
+class CacheShard : public List<CacheItemBase>
 {
 public:
-	CacheBase();
+	CacheShard();
+	~CacheShard();
+
+	CacheItemBase** get_bucket(int64_t position);
+	void insert(CacheItemBase *item);
+// Remove the item from the hash table and delete it.
+	void remove_item(CacheItemBase *item);
+	void remove_all();
+// Double the hash table when it gets crowded.
+	void grow();
+
+	Mutex *lock;
+	CacheItemBase **table;
+	int table_size;
+	int total_items;
+	int64_t memory_usage;
+// Statistics for CacheBudget
+	int64_t hits;
+	int64_t misses;
+	int64_t evictions;
+};
+
+
+
+class CacheBase : public CacheAccount
+{
+public:
+	CacheBase(const char *title);
 	virtual ~CacheBase();
 
 	int get_age();
@@ -71,15 +116,27 @@ public:
 // Remove all items with the asset id.
 	void remove_asset(Asset *asset);
 
-// Insert item in list in ascending position order.
+// Lock the shard containing the position.  Must be done before calling
+// put_item, get_item, next_item or touch_item.
+	void lock_position(int64_t position, const char *location);
+
+// Insert item in the shard of its position.
 	void put_item(CacheItemBase *item);
 
-// Get first item from list with matching position or 0 if none found.
+// Get first item from the shard with matching position or 0 if none found.
 	CacheItemBase* get_item(int64_t position);
+// Get next item after the argument with the same position or 0.
+	CacheItemBase* next_item(CacheItemBase *item);
+
+// Update the age of the item and move it to the end of the age order.
+	void touch_item(CacheItemBase *item);
+// Count a lookup for the statistics.
+	void record_lookup(int64_t position, int found);
 
 // Called when done with the item returned by get_.
+// The position is the one passed to get_.
 // Ignore if item was 0.
-	void unlock();
+	void unlock(int64_t position);
 
 // Get ID of oldest member.
 // Called by MWindow::age_caches.
@@ -91,9 +148,17 @@ public:
 // Calculate current size of cache in bytes
 	int64_t get_memory_usage();
 
-	Mutex *lock;
-// Current position of search
-	CacheItemBase *current_item;
+	void get_statistics(int64_t *hits, 
+		int64_t *misses, 
+		int64_t *evictions);
+
+// Total items in all shards
+	int total();
+
+private:
+	CacheShard* get_shard(int64_t position);
+
+	CacheShard *shards[CACHE_SHARDS];
 };
 
 
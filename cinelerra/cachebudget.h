@@ -0,0 +1,86 @@
+
+/*
+ * CINELERRA
+ * Copyright (C) 2008 Adam Williams <broadcast at earthling dot net>
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * 
+ */
+
+#ifndef CACHEBUDGET_H
+#define CACHEBUDGET_H
+
+#include "arraylist.h"
+#include "cachebudget.inc"
+#include "mutex.inc"
+#include "preferences.inc"
+
+#include <stdint.h>
+
+// Central accounting of the memory used by all the caches.
+// Every cache registers with the budget, which evicts the globally
+// oldest items until the total is below Preferences::cache_size.
+
+// Interface each cache implements to be managed by the budget.
+class CacheAccount
+{
+public:
+	CacheAccount(const char *title);
+	virtual ~CacheAccount();
+
+// Get ID of oldest member or 0x7fffffff if empty.
+	virtual int get_oldest() = 0;
+// Delete oldest item.  Return 0 if successful.  Return 1 if nothing to delete.
+	virtual int delete_oldest() = 0;
+// Current size of cache in bytes.
+	virtual int64_t get_memory_usage() = 0;
+// Totals since the cache was created.
+	virtual void get_statistics(int64_t *hits, 
+		int64_t *misses, 
+		int64_t *evictions) = 0;
+
+	const char *title;
+};
+
+
+class CacheBudget
+{
+public:
+	CacheBudget(Preferences *preferences);
+	~CacheBudget();
+
+	void register_cache(CacheAccount *cache);
+	void unregister_cache(CacheAccount *cache);
+
+// Delete the oldest items from all the caches until the total memory
+// usage is under the budget.  The usage of each cache is read once and
+// updated only for the cache an item was deleted from.
+	void age();
+
+// Total bytes used by all the caches.
+	int64_t get_memory_usage();
+// Hits as percentage of all lookups in all caches.
+	int get_hit_rate();
+
+	void dump();
+
+private:
+	Mutex *lock;
+	ArrayList<CacheAccount*> caches;
+	Preferences *preferences;
+};
+
+
+#endif
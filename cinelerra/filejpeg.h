@@ -43,10 +43,13 @@ public:
 	static int get_best_colormodel(Asset *asset, int driver);
 	int colormodel_supported(int colormodel);
 	int read_frame(VFrame *frame, VFrame *data);
+	int read_frame(VFrame *frame, VFrame *data, FrameReaderUnit *unit);
 	int write_frame(VFrame *frame, VFrame *data, FrameWriterUnit *unit);
 	int can_copy_from(Edit *edit, int64_t position);
 	int read_frame_header(char *path);
 	FrameWriterUnit* new_writer_unit(FrameWriter *writer);
+	FrameReaderUnit* new_reader_unit(FrameReader *reader);
+	int decompress(void **decompressor, VFrame *output, VFrame *input);
 
 	void *decompressor;
 };
@@ -62,6 +65,17 @@ public:
 	void *compressor;
 };
 
+// Each read ahead unit has its own decompressor
+class JPEGReaderUnit : public FrameReaderUnit
+{
+public:
+	JPEGReaderUnit(FileJPEG *file, FrameReader *reader);
+	~JPEGReaderUnit();
+
+	FileJPEG *file;
+	void *decompressor;
+};
+
 class JPEGConfigVideo : public BC_Window
 {
 public:
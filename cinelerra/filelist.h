@@ -27,8 +27,12 @@
 #include "filelist.inc"
 #include "loadbalance.h"
 #include "mutex.inc"
+#include "thread.h"
 #include "vframe.inc"
 
+// Maximum memory for frames decoded ahead of the read position
+#define READ_AHEAD_BYTES 0x10000000
+
 // Any file which is a list of frames.
 // FileList handles both frame files and indexes of frame files.
 
@@ -63,6 +67,10 @@ public:
 // subclass returns whether the asset format is a list or single file
 	virtual int read_frame(VFrame *frame, VFrame *data) { return 0; };
 	virtual int write_frame(VFrame *frame, VFrame *data, FrameWriterUnit *unit) { return 0; };
+// Decode a frame in a read ahead unit.  The default serializes decoding since
+// most subclasses keep decoder state in the file object.  Subclasses which
+// can decode in parallel override this.
+	virtual int read_frame(VFrame *frame, VFrame *data, FrameReaderUnit *unit);
 
 
 	int write_list_header();
@@ -75,6 +83,11 @@ public:
 	FrameWriterUnit* get_unit(int number);
 
 	virtual FrameWriterUnit* new_writer_unit(FrameWriter *writer);
+	virtual FrameReaderUnit* new_reader_unit(FrameReader *reader);
+// Get the path of a list frame to read, with the VFS prefix
+	char* get_read_path(int64_t number, char *string);
+// Total frames which can be read or -1 if unknown
+	int64_t get_read_length();
 
 // Temp storage for compressed data
 	VFrame *data;
@@ -93,7 +106,12 @@ private:
 	int frame_type;
 	int list_type;
 	Mutex *table_lock;
+// Serializes read_frame in subclasses which can't decode in parallel
+	Mutex *decode_lock;
 	FrameWriter *writer;
+	FrameReadAhead *read_ahead;
+// Last frame read, to get the playback direction
+	int64_t last_number;
 	int return_value;
 	int first_number;
 	int number_start;
@@ -155,6 +173,95 @@ public:
 
 
 
+class FrameReaderPackage : public LoadPackage
+{
+public:
+	FrameReaderPackage();
+	~FrameReaderPackage();
+
+	VFrame *output;
+	int result;
+};
+
+
+
+
+class FrameReaderUnit : public LoadClient
+{
+public:
+	FrameReaderUnit(FrameReader *server);
+	virtual ~FrameReaderUnit();
+
+	void process_package(LoadPackage *package);
+
+	FrameReader *server;
+// Compressed data
+	VFrame *data;
+};
+
+
+
+
+class FrameReader : public LoadServer
+{
+public:
+	FrameReader(FileList *file, FrameReadAhead *read_ahead, int cpus);
+	~FrameReader();
+
+// Decode the frames in parallel.  The frame numbers are set in the frames.
+	void read_frames(ArrayList<VFrame*> *frames);
+	void init_packages();
+	LoadClient* new_client();
+	LoadPackage* new_package();
+
+	FileList *file;
+	FrameReadAhead *read_ahead;
+	ArrayList<VFrame*> *frames;
+};
+
+
+
+
+// Decodes the frames after the read position in the background
+class FrameReadAhead : public Thread
+{
+public:
+	FrameReadAhead(FileList *file, int cpus);
+	~FrameReadAhead();
+
+// Start decoding frames from number in the direction
+	void start_reading(int64_t number, 
+		int direction, 
+		int w, 
+		int h, 
+		int color_model);
+// Copy a decoded frame, waiting if it's being decoded.
+// Returns 1 if the frame isn't read ahead.
+	int get_frame(VFrame *frame, int64_t number);
+// Called by the units when a frame is decoded
+	void frame_done(VFrame *frame, int result);
+	int64_t get_memory_usage();
+	void run();
+
+	FileList *file;
+	FrameReader *reader;
+// Decoded frames
+	ArrayList<VFrame*> ready;
+// Frames being decoded
+	ArrayList<VFrame*> decoding;
+	ArrayList<VFrame*> spare;
+	Mutex *frame_lock;
+	Condition *input_lock;
+	Condition *frame_ready;
+	int done;
+	int64_t next_number;
+	int direction;
+	int w;
+	int h;
+	int color_model;
+};
+
+
 
 
 #endif
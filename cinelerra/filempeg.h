@@ -28,7 +28,12 @@
 #include "filebase.h"
 #include <lame/lame.h>
 #include "libmpeg3.h"
+#include "mutex.inc"
 #include "thread.h"
+#include "vframe.inc"
+
+// Frames buffered between the renderer and the video encoder
+#define MPEG_QUEUE_FRAMES 4
 
 
 extern "C"
@@ -41,7 +46,11 @@ int mpeg2enc(int argc, char *argv[]);
 void mpeg2enc_set_w(int width);
 void mpeg2enc_set_h(int height);
 void mpeg2enc_set_rate(double rate);
-void mpeg2enc_set_input_buffers(int eof, char *y, char *u, char *v);
+void mpeg2enc_set_input_callback(int (*callback)(void *ptr, 
+		unsigned char *frame[], 
+		int y_bytes, 
+		int uv_bytes), 
+	void *ptr);
 
 
 
@@ -49,6 +58,7 @@ void mpeg2enc_set_input_buffers(int eof, char *y, char *u, char *v);
 void toolame_init_buffers();
 int toolame(int argc, char **argv);
 int toolame_send_buffer(char *data, int bytes);
+int toolame_send_samples(double **samples, int channels, int len);
 
 
 }
@@ -115,6 +125,26 @@ private:
 	ArrayList<char*> vcommand_line;
 	void append_vcommand_line(const char *string);
 
+// Frames waiting for the video encoder.  write_frames blocks only when
+// MPEG_QUEUE_FRAMES are waiting.
+	ArrayList<VFrame*> frame_queue;
+// Frames the encoder is finished with
+	ArrayList<VFrame*> frame_pool;
+	Mutex *queue_lock;
+	Condition *queue_ready;
+	Condition *queue_space;
+// Encoder got the end of the sequence
+	int queue_eof;
+	int encoder_error;
+	VFrame* get_queue_frame(int w, int h, int color_model);
+	void queue_frame(VFrame *frame);
+// Called by the encoder thread.  Returns 0 at the end of the sequence.
+	VFrame* next_queued_frame();
+	void release_frame(VFrame *frame);
+	static int mpeg2enc_input(void *ptr, 
+		unsigned char *frame[], 
+		int y_bytes, 
+		int uv_bytes);
 
 
 // DVB capture
@@ -125,14 +155,7 @@ private:
 
 // MJPEGtools encoder
 	FILE *mjpeg_out;	
-	int mjpeg_error;
-	Condition *next_frame_lock;
-	Condition *next_frame_done;
-	int mjpeg_eof;
 	int wrote_header;
-	unsigned char *mjpeg_y;	
-	unsigned char *mjpeg_u;	
-	unsigned char *mjpeg_v;	
 	char mjpeg_command[BCTEXTLEN];
 
 
@@ -147,11 +170,6 @@ private:
 	void append_acommand_line(const char *string);
 
 
-// Temporary for color conversion
-	VFrame *temp_frame;
-
-	unsigned char *toolame_temp;
-	int toolame_allocation;
 	int toolame_result;
 
 
@@ -23,6 +23,7 @@
 #define FILEOGG_H
 
 #include "../config.h"
+#include "arraylist.h"
 #include "filebase.h"
 #include "file.inc"
 
@@ -45,6 +46,15 @@ typedef struct
 	int wlen;
 } sync_window_t;
 
+// Byte offset of every page in a logical stream and the granule position
+// of the last packet finished on or before the page.
+typedef struct
+{
+	long serialno;
+	ArrayList<int64_t> offsets;
+	ArrayList<int64_t> granules;
+} ogg_page_index_t;
+
 typedef struct
 {
     ogg_page audiopage;
@@ -153,6 +163,23 @@ private:
 	int ogg_seek_to_keyframe(sync_window_t *sw, long serialno, int64_t frame, int64_t *keyframe_number);
 	int ogg_seek_to_databegin(sync_window_t *sw, long serialno);
 
+// The page index is built on the first open and stored next to the peak
+// index.  It's rebuilt when the size or modification time of the file changes.
+	void open_page_index(long video_serialno, long audio_serialno);
+	int read_page_index(char *path);
+	int write_page_index(char *path);
+	void build_page_index();
+	void delete_page_index();
+	ogg_page_index_t* get_page_index(long serialno);
+// First page which finishes a packet at or after the frame or sample.  
+// Returns the total pages if there is none.
+	int ogg_index_search(ogg_page_index_t *index, int64_t position, int is_video);
+	int ogg_get_indexed_page(sync_window_t *sw, ogg_page_index_t *index, int number, ogg_page *og);
+
+	ogg_page_index_t *video_index;
+	ogg_page_index_t *audio_index;
+	int64_t file_mtime;
+
 
 	int64_t start_sample; // first and last sample inside this file
 	int64_t last_sample;	
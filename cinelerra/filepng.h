@@ -43,6 +43,7 @@ public:
 	static int get_best_colormodel(Asset *asset, int driver);
 	int colormodel_supported(int colormodel);
 	int read_frame(VFrame *frame, VFrame *data);
+	int read_frame(VFrame *output, VFrame *input, FrameReaderUnit *unit);
 	int write_frame(VFrame *frame, VFrame *data, FrameWriterUnit *unit);
 	int can_copy_from(Edit *edit, int64_t position);
 	FrameWriterUnit* new_writer_unit(FrameWriter *writer);
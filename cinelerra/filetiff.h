@@ -51,6 +51,7 @@ public:
 	int get_best_colormodel(Asset *asset, int driver);
 	int read_frame_header(char *path);
 	int read_frame(VFrame *output, VFrame *input);
+	int read_frame(VFrame *output, VFrame *input, FrameReaderUnit *unit);
 	int write_frame(VFrame *frame, VFrame *data, FrameWriterUnit *unit);
 	FrameWriterUnit* new_writer_unit(FrameWriter *writer);
 
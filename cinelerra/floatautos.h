@@ -52,6 +52,12 @@ public:
 	float get_value(int64_t position, 
 		FloatAuto* &previous,
 		FloatAuto* &next);
+// Get values for len positions from start in direction.
+// Keyframes are looked up once per segment instead of once per position.
+	void get_values(int64_t start,
+		int64_t len,
+		int direction,
+		double *values);
 // Helper: just calc the bezier function without doing any lookup of nodes
  	static float calculate_bezier(FloatAuto *previous, FloatAuto *next, int64_t position);
  	static float calculate_bezier_derivation(FloatAuto *previous, FloatAuto *next, int64_t position);
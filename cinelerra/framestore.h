@@ -0,0 +1,82 @@
+
+/*
+ * CINELERRA
+ * Copyright (C) 2008 Adam Williams <broadcast at earthling dot net>
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * 
+ */
+
+#ifndef FRAMESTORE_H
+#define FRAMESTORE_H
+
+// Frames rendered by the background renderer are stored on disk under the
+// hash of everything in the EDL which contributes to them.  Edits elsewhere
+// in the timeline don't change the hash so the frames stay valid across
+// edits and sessions.
+
+#include "arraylist.h"
+#include "auto.inc"
+#include "autos.inc"
+#include "edit.inc"
+#include "edl.inc"
+#include "mutex.inc"
+#include "plugin.inc"
+#include "pluginserver.inc"
+#include "preferences.inc"
+#include "vframe.inc"
+
+#include <stdint.h>
+
+class FrameStore
+{
+public:
+	FrameStore(Preferences *preferences, ArrayList<PluginServer*> *plugindb);
+	~FrameStore();
+
+// Hash the session, tracks, edits, plugins, and automation which produce
+// the output frame at position.  Returns 0 if the frame depends on other
+// positions and can't be stored.  The EDL must not change between calls
+// with the same pointer.
+	uint64_t hash_frame(EDL *edl, int64_t position);
+// Returns 1 if the frame doesn't exist or has a different format.
+	int read_frame(uint64_t hash, VFrame *frame);
+	int write_frame(uint64_t hash, VFrame *frame);
+
+private:
+	uint64_t hash_autos(uint64_t hash, Autos *autos, int64_t position);
+	uint64_t hash_auto(uint64_t hash, Auto *current, int64_t position);
+	uint64_t hash_edit(uint64_t hash, Edit *edit, int64_t position);
+	uint64_t hash_plugin(uint64_t hash, Plugin *plugin, int64_t position);
+// Plugins which declare they read other positions or keep state between frames
+	int is_temporal(Plugin *plugin, int64_t position);
+// Serialized objects of the EDL by address, sorted by address.
+	int get_cached(void *object, uint64_t *hash);
+	void put_cached(void *object, uint64_t hash);
+	void get_path(char *path, uint64_t hash);
+// Delete the least recently used frames until the store fits.
+	void prune();
+
+	Preferences *preferences;
+	ArrayList<PluginServer*> *plugindb;
+	EDL *cached_edl;
+	ArrayList<void*> cached_objects;
+	ArrayList<uint64_t> cached_hashes;
+// Bytes used by the store.  -1 until the directory is scanned.
+	int64_t total_bytes;
+	Mutex *lock;
+};
+
+#endif
@@ -34,6 +34,26 @@
 #include "bctimer.inc"
 #include "tracks.inc"
 
+#include <stdint.h>
+
+// Peak pyramid stored beside the index.  Level 0 has the zoom of the
+// index and every following level halves the number of peaks.  Peaks are
+// quantized to 16 bits of scale.
+#define PYRAMID_ID "PEAKPYR1"
+
+typedef struct
+{
+	char id[8];
+// Size of the source file and zoom of the index it was built from
+	int64_t index_bytes;
+	int64_t index_zoom;
+	int32_t channels;
+	int32_t levels;
+// Amplitude of a peak of 32767
+	float scale;
+	int32_t reserved;
+} index_pyramid_t;
+
 class IndexFile
 {
 public:
@@ -58,20 +78,42 @@ public:
 	void remove_index();
 	int read_info(Asset *test_asset = 0);
 	void write_info();
+// Map the peak pyramid of an opened index
+	int open_pyramid();
+// Build the peak pyramid from the index file
+	int create_pyramid();
+	void close_pyramid();
+	static void get_pyramid_filename(char *pyramid_filename, 
+		char *index_filename);
 
 	MWindow *mwindow;
 	char index_filename[BCTEXTLEN], source_filename[BCTEXTLEN];
 	Asset *asset;
 	Timer *redraw_timer;
+// Processors one index may be built with
+	int cpus;
 
 private:
 	void update_mainasset();
+// Number of chunks to read the asset in concurrently
+	int get_total_chunks(int64_t length_source);
+	int create_chunks(int total_chunks, 
+		int64_t length_source, 
+		MainProgressBar *progress);
 
 	int open_file();
 	int open_source(File *source);
 	int64_t get_required_scale(File *source);
 	FILE *file;
 	int64_t file_length;   // Length of index file in bytes
+// Mapped peak pyramid
+	unsigned char *pyramid_data;
+	int64_t pyramid_length;
+	index_pyramid_t *pyramid;
+// Offset and size of every level of every channel in peaks * 2
+	int64_t *pyramid_offsets;
+	int64_t *pyramid_sizes;
+	int16_t *pyramid_peaks;
 	int interrupt_flag;    // Flag set when index building is interrupted
 };
 
@@ -24,11 +24,14 @@
 
 #include "asset.inc"
 #include "condition.inc"
+#include "file.inc"
 #include "indexfile.inc"
 #include "mwindow.inc"
 #include "thread.h"
 
 #define TOTAL_BUFFERS 2
+// Samples read at a time
+#define INDEX_BUFFER_SIZE 65536
 
 // Recieves buffers from Indexfile and calculates the index.
 
@@ -49,6 +52,17 @@ public:
 	void stop_build();
 	void run();
 
+// Reduce len samples of one channel to peak pairs in index_buffer.
+// highpoint - offset of the current pair in index_buffer
+// frame_position - samples already in the current pair.  When it equals
+//     zoom, the next sample starts a new pair 2 floats after highpoint.
+	static void reduce(float *index_buffer, 
+		double *buffer, 
+		int64_t len, 
+		int64_t zoom,
+		int64_t &highpoint,
+		int64_t &frame_position);
+
 	IndexFile *index_file;
 	MWindow *mwindow;
 	Asset *asset;
@@ -65,5 +79,32 @@ private:
 };
 
 
+// Reads a range of samples from its own copy of the source and stores the
+// peaks directly in the index.  The range starts on a peak boundary so
+// chunks of the same asset can run concurrently.
+class IndexChunk : public Thread
+{
+public:
+	IndexChunk(MWindow *mwindow, 
+		Asset *asset, 
+		int64_t start_position, 
+		int64_t end_position);
+	~IndexChunk();
+
+	void run();
+
+	MWindow *mwindow;
+	Asset *asset;
+// Range of samples to read
+	int64_t start_position, end_position;
+// Samples completed for the progress bar
+	int64_t position;
+// Set by the IndexFile to stop reading
+	int interrupt_flag;
+// Set if the source couldn't be read
+	int result;
+};
+
+
 
 #endif
@@ -22,6 +22,7 @@
 #ifndef LOADBALANCE_H
 #define LOADBALANCE_H
 
+#include "arraylist.h"
 #include "condition.inc"
 #include "mutex.inc"
 #include "thread.h"
@@ -33,9 +34,14 @@
 // There is no guarantee that all the load clients will be run in a 
 // processing operation.
 
+// The clients don't have their own threads.  process_packages submits one
+// task per client to a LoadPool shared by all the LoadServers in the process.
+// Each task processes packages until none are left.  The calling thread
+// runs the tasks which no worker has taken yet, so LoadServers can be nested.
 
-class LoadServer;
 
+class LoadServer;
+class LoadPool;
 
 
 class LoadPackage
@@ -50,14 +56,15 @@ public:
 };
 
 
-class LoadClient : public Thread
+class LoadClient
 {
 public:
 	LoadClient(LoadServer *server);
 	LoadClient();
 	virtual ~LoadClient();
 
-// Called when run as distributed client
+// Called by the LoadPool when run as distributed client.
+// Processes packages until none are left.
 	void run();
 // Called when run as a single_client
 	void run_single();
@@ -65,10 +72,7 @@ public:
 	int get_package_number();
 	LoadServer* get_server();
 
-	int done;
 	int package_number;
-	Condition *input_lock;
-	Condition *completion_lock;
 	LoadServer *server;
 };
 
@@ -82,6 +86,7 @@ public:
 	virtual ~LoadServer();
 
 	friend class LoadClient;
+	friend class LoadPool;
 
 // Called first in process_packages.  Should also initialize clients.
 	virtual void init_packages() {};
@@ -123,6 +128,60 @@ private:
 	int total_clients;
 	int is_single;
 	Mutex *client_lock;
+// Clients submitted to the pool and not finished
+	int pending_clients;
+	Condition *completion_lock;
+};
+
+
+
+// Thread in the LoadPool.  Runs clients from its own queue first, then
+// steals from the shared queue and the other workers.
+class LoadWorker : public Thread
+{
+public:
+	LoadWorker(LoadPool *pool, int number);
+// The pool sets done and wakes every worker first.
+	~LoadWorker();
+
+	void run();
+
+	LoadPool *pool;
+	int number;
+	int done;
+};
+
+
+
+class LoadPool
+{
+public:
+	LoadPool(int total_workers);
+	~LoadPool();
+
+// Get the pool shared by all LoadServers.  Created on the first call.
+	static LoadPool* get_pool();
+
+// Queue a client to run.  Clients submitted by a worker go to its own queue.
+	void submit(LoadClient *client);
+// Remove a queued client of the server and run it in the current thread.
+// Returns 1 if nothing was queued for the server.
+	int run_queued(LoadServer *server);
+// Take the next client for the worker.  Returns 0 if nothing is queued.
+	LoadClient* get_client(int worker);
+
+	int total_workers;
+	LoadWorker **workers;
+// Last queue is shared by threads which aren't workers.
+	ArrayList<LoadClient*> **queues;
+	Mutex **queue_locks;
+// Incremented for every submitted client
+	Condition *work_lock;
+
+private:
+	int get_worker_number();
+	static Mutex *pool_lock;
+	static LoadPool *pool;
 };
 
 
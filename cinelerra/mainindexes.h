@@ -30,6 +30,8 @@
 #include "mwindow.inc"
 #include "thread.h"
 
+class MainIndexesBuilder;
+
 // Runs in a loop, creating new index files as needed
 
 class MainIndexes : public Thread
@@ -45,8 +47,12 @@ public:
 	void start_build();
 	void run();
 	void interrupt_build();
+// Stop all the builders without waiting
+	void interrupt_builders();
 	void load_next_assets();
 	void delete_current_assets();
+// Get the next asset for a builder.  Returns 0 when there are none.
+	Asset* get_next_build();
 
 	ArrayList<Asset*> current_assets;
 	ArrayList<Asset*> next_assets;
@@ -57,6 +63,25 @@ public:
 	Condition *input_lock;                   // Lock until new data is to be indexed
 	Mutex *next_lock;                    // Lock changes to next assets
 	Condition *interrupt_lock;               // Force blocking until thread is finished
+// Assets without an index.  Builders take them in order.
+	ArrayList<Asset*> build_assets;
+	int current_build;
+	ArrayList<MainIndexesBuilder*> builders;
+	Mutex *build_lock;                   // Lock build_assets and builders
+};
+
+// Builds indexes for the assets of a MainIndexes concurrently with the
+// other builders.
+class MainIndexesBuilder : public Thread
+{
+public:
+	MainIndexesBuilder(MainIndexes *main_indexes, int cpus);
+	~MainIndexesBuilder();
+
+	void run();
+
+	MainIndexes *main_indexes;
+	MWindow *mwindow;
 	IndexFile *indexfile;
 };
 
@@ -69,6 +69,11 @@ private:
 	char* data_after;	// the state after a change
 
 	void capture_state();
+// Replace data_after with a new [] string.
+	void set_state(char *data);
+// Make the top item of the stack absolute before an item which doesn't
+// store the EDL is put on it.
+	void cover_item(List<UndoStackItem> *stack, UndoStackItem *item);
 	void prune_undo();
 	bool ignore_push(char *description, uint32_t load_flags, void* creator);
 
@@ -31,6 +31,7 @@
 #include "bcwindowbase.inc"
 #include "brender.inc"
 #include "cache.inc"
+#include "cachebudget.inc"
 #include "channel.inc"
 #include "channeldb.inc"
 #include "cwindow.inc"
@@ -436,6 +437,8 @@ public:
 // Cache drawing doesn't wait for file decoding.
 	FrameCache *frame_cache;
 	WaveCache *wave_cache;
+// Keeps the sum of the timeline caches under Preferences::cache_size
+	CacheBudget *cache_budget;
 	Preferences *preferences;
 	PreferencesThread *preferences_thread;
 	MainSession *session;
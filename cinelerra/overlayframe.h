@@ -55,6 +55,13 @@
 // Another advantage to the two step process is further optimization can be achieved
 // by leaving out translation or scaling.
 
+// When the output lands on integer boundaries the translation is only a
+// blend, so the scaling units blend their rows directly into the output
+// one tile at a time instead of filling a temp frame.
+
+// Bytes in the tile each scaling unit blends from
+#define OVERLAY_TILE_SIZE 0x40000
+
 // Translation
 
 typedef struct
@@ -149,9 +156,16 @@ public:
 	void dump_bilinear(bilinear_table_t *table, int total);
 
 	void process_package(LoadPackage *package);
+// Get the destination for a scaled row.  Blends the tile when it fills up.
+	unsigned char* get_row(int row);
+// Blend the scaled rows in the tile into the output
+	void blend_tile();
 	
 	OverlayFrame *overlay;
 	ScaleEngine *engine;
+// Scaled rows waiting to be blended
+	VFrame *tile;
+	int tile_row1, tile_row2;
 };
 
 class ScaleEngine : public LoadServer
@@ -175,6 +189,13 @@ public:
 	int out_w_int;
 	int out_h_int;
 	int interpolation_type;
+// If set, scaled rows are blended into this at blend_x, blend_y instead of
+// being written to scale_output.
+	VFrame *blend_output;
+	int blend_x;
+	int blend_y;
+	float alpha;
+	int mode;
 };
 
 
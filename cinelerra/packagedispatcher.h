@@ -25,6 +25,7 @@
 
 #include "arraylist.h"
 #include "assets.inc"
+#include "bctimer.inc"
 #include "edl.inc"
 #include "mutex.inc"
 #include "mwindow.inc"
@@ -34,6 +35,26 @@
 
 
 
+// What a farm client is rendering.  Rates are measured from the progress
+// updates so they're current while the package is still rendering.
+class PackageAssignment
+{
+public:
+	PackageAssignment();
+	~PackageAssignment();
+
+// Package sent to the client or 0
+	RenderPackage *package;
+// Package in the dispatcher table.  Differs from package for speculative copies.
+	RenderPackage *original;
+// The other copy finished first.
+	int cancelled;
+	Timer *timer;
+	int64_t samples_rendered;
+// Samples per second from the last progress update
+	double rate;
+};
+
 // Allocates fragments given a total start and total end.
 // Checks the existence of every file.
 // Adjusts package size for load.
@@ -63,6 +84,13 @@ public:
 	int64_t get_progress_max();
 	int packages_are_done();
 
+// Progress from a farm client.  Updates the measured rate of the client.
+// Returns 0 if the progress belongs to a speculative copy and shouldn't
+// be added to the total.
+	int update_progress(int client_number, int64_t samples);
+// The package the client is rendering was finished by another client.
+	int is_cancelled(int client_number);
+
 private:
 	EDL *edl;
 	int64_t audio_position;
@@ -89,6 +117,15 @@ private:
 	Mutex *package_lock;
 
 	PackagingEngine *packaging_engine;
+
+	PackageAssignment* get_assignment(int client_number);
+// Called when the client requests its next package
+	void finish_package(int client_number);
+// Render a copy of the slowest outstanding package on an idle client.
+	RenderPackage* speculate_package(int client_number);
+	int can_speculate();
+	static void get_copy_path(char *output, char *path);
+	ArrayList<PackageAssignment*> assignments;
 };
 
 
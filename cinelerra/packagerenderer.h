@@ -29,6 +29,7 @@
 #include "edit.inc"
 #include "edl.inc"
 #include "file.inc"
+#include "framestore.inc"
 #include "maxchannels.h"
 #include "mwindow.inc"
 #include "playabletracks.inc"
@@ -153,6 +154,8 @@ public:
 	int64_t video_read_length;
 	int64_t video_write_length;
 	int64_t video_write_position;
+// Background rendering reuses and stores frames here
+	FrameStore *frame_store;
 };
 
 
@@ -105,6 +105,8 @@ public:
 // X11 options
 	char x11_host[BCTEXTLEN];
 	int x11_use_fields;
+// Frames queued for display before rendering blocks
+	int x11_buffers;
 // Values for x11_use_fields
 	enum
 	{
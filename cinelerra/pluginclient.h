@@ -246,6 +246,9 @@ public:
 	virtual int is_multichannel();
 	virtual int is_synthesis();
 	virtual int is_transition();
+// The output depends on other positions or earlier frames so it can't be
+// reused from the background render's frame store.
+	virtual int is_temporal();
 	virtual const char* plugin_title();   // return the title of the plugin
 	virtual VFrame* new_picon();
 	virtual Theme* new_theme();
@@ -322,6 +322,8 @@ public:
 	int uses_gui;
 // Plugin is a transition
 	int transition;
+// Reads other positions or keeps state between frames
+	int temporal;
 // name of plugin in english.
 // Compared against the title value in the plugin for resolving symbols.
 	char *title;
@@ -100,10 +100,17 @@ public:
 	int use_brender;
 // Number of frames in a brender job.
 	int brender_fragment;
+// Directory of frames rendered by brender, named by the hash of the EDL
+// which produced them.
+	char frame_store_directory[BCTEXTLEN];
+// Bytes of disk used by the frame store
+	int64_t frame_store_size;
 // Size of cache in bytes.
 // Several caches of cache_size exist so multiply by 4.
 // rendering, playback, timeline, preview
 	int64_t cache_size;
+// Bytes of memory used by the undo stack
+	int64_t undo_memory;
 
 	int use_renderfarm;
 	int renderfarm_port;
@@ -37,6 +37,7 @@ public:
 	int get_id();
 	long get_size();
 
+// 0 if the segment couldn't be created or attached
 	char *data;
 	long size;
 	int shmid;
@@ -0,0 +1,59 @@
+
+/*
+ * CINELERRA
+ * Copyright (C) 2008 Adam Williams <broadcast at earthling dot net>
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * 
+ */
+
+#ifndef UNDODELTA_H
+#define UNDODELTA_H
+
+#include <stdint.h>
+
+// Compressed difference between two EDL XML strings for the undo stack.
+// The target is stored as line copies from the reference and inserted
+// text, compressed with zlib.  A delta encoded against an empty reference
+// contains the whole target and can be decoded against anything.
+
+class UndoDelta
+{
+public:
+	UndoDelta();
+	~UndoDelta();
+
+// Store target relative to reference.
+	void encode(const char *reference, const char *target);
+// Return a new [] string of the target or 0 if the reference isn't the one 
+// the delta was encoded against.
+	char* decode(const char *reference);
+// Make the delta independant of the reference.
+	void make_absolute(const char *reference);
+	int is_absolute();
+// Bytes of compressed data
+	int get_size();
+
+private:
+	unsigned char *data;
+	int data_size;
+	int uncompressed_size;
+	int target_size;
+	int reference_size;
+	uint32_t reference_checksum;
+};
+
+
+#endif
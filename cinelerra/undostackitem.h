@@ -40,7 +40,8 @@ public:
 // - change the EDL to undo an operation;
 // - change the internal information of the item so that the next invocation
 //   of undo() does a redo (i.e. undoes the undone operation).
-	virtual void undo();
+// Return 1 if the operation couldn't be undone.  The item is left unchanged.
+	virtual int undo();
 
 // Return the amount of memory used for the data associated with this
 // object in order to enable limiting the amount of memory used by the
@@ -48,6 +49,9 @@ public:
 // Ignore overhead and just report the specific data values that the
 // derived object adds.
 	virtual int get_size();
+
+// Return 1 if the item is a MainUndoStackItem storing the whole EDL.
+	virtual int is_edl_state();
 	
 	
 // command description for the menu item
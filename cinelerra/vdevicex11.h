@@ -23,10 +23,12 @@
 #define VDEVICEX11_H
 
 #include "canvas.inc"
+#include "condition.inc"
 #include "edl.inc"
 #include "guicast.h"
 #include "maskauto.inc"
 #include "maskautos.inc"
+#include "mutex.inc"
 #include "pluginclient.inc"
 #include "thread.h"
 #include "vdevicebase.h"
@@ -36,9 +38,13 @@
 // output_frame is a temporary converted to the device format
 #define BITMAP_TEMP    1
 
+class VDeviceX11Presenter;
+
 class VDeviceX11 : public VDeviceBase
 {
 public:
+	friend class VDeviceX11Presenter;
+
 	VDeviceX11(VideoDevice *device, Canvas *output);
 	~VDeviceX11();
 
@@ -159,6 +165,55 @@ private:
 	BC_Capture *capture_bitmap;
 // Set when OpenGL rendering has cleared the frame buffer before write_buffer
 	int is_cleared;
+// Draws the bitmap ring buffers so rendering doesn't wait for the X server
+	VDeviceX11Presenter *presenter;
+};
+
+
+
+// Transfer coordinates for a ring buffer waiting to be drawn
+class VDeviceX11Frame
+{
+public:
+	int dest_x, dest_y, dest_w, dest_h;
+	int src_x, src_y, src_w, src_h;
+};
+
+class VDeviceX11Presenter : public Thread
+{
+public:
+	VDeviceX11Presenter(VDeviceX11 *device);
+	~VDeviceX11Presenter();
+
+// Queue a ring buffer of the bitmap for drawing
+	void present(int ringbuffer, 
+		int dest_x, 
+		int dest_y, 
+		int dest_w, 
+		int dest_h,
+		int src_x, 
+		int src_y, 
+		int src_w, 
+		int src_h);
+// Block until the current ring buffer of the bitmap can be written.
+// Must be called without the canvas locked.
+	void wait_buffer(int ring_buffers);
+// Block until all the queued ring buffers are drawn
+	void wait_idle();
+	void run();
+
+	VDeviceX11 *device;
+	VDeviceX11Frame frames[BITMAP_MAX_RING];
+// Ring buffers in drawing order
+	ArrayList<int> queue;
+// Ring buffers queued or being drawn
+	int pending;
+// Callers of wait_buffer blocked on draw_done
+	int waiting;
+	int done;
+	Mutex *queue_lock;
+	Condition *input_lock;
+	Condition *draw_done;
 };
 
 #endif
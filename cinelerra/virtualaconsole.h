@@ -56,11 +56,19 @@ public:
 
 // cause audio device to quit
 	void send_last_output_buffer();
+// Render the track of an exit node into its entry in track_buffers
+	int render_exit_node(int number);
 
 // Temporary for audio rendering.  This stores each track's output before it is
 // mixed into the device buffer.
 	double *output_temp;
 	int output_allocation;
+// Output of each exit node when the tracks are rendered concurrently.
+// Allocated to output_allocation.
+	ArrayList<double*> track_buffers;
+// Arguments of process_buffer for render_exit_node
+	int64_t input_len;
+	int64_t input_position;
 
 	ARender *arender;
 };
@@ -61,6 +61,21 @@ public:
 		int64_t len,
 		int64_t sample_rate);
 
+// The two halves of render for a module.  When tracks are rendered
+// concurrently, render_track runs in the VirtualConsoleEngine and the
+// tracks are mixed in order afterwards.
+// Render the track with its effects and fade into output_temp.
+	void render_track(double *output_temp,
+		int64_t start_position,
+		int64_t len,
+		int64_t sample_rate);
+// Pan output_temp into the output channels.
+	void mix_track(double **audio_out, 
+		double *output_temp,
+		int64_t start_position,
+		int64_t len, 
+		int64_t sample_rate);
+
 private:
 // need *arender for peak updating
 	int render_as_module(double **audio_out, 
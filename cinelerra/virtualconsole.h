@@ -24,12 +24,16 @@
 
 #include "arraylist.h"
 #include "commonrender.inc"
+#include "loadbalance.h"
 #include "module.inc"
 #include "playabletracks.inc"
 #include "renderengine.inc"
 #include "track.inc"
 #include "virtualnode.inc"
 
+class VirtualConsoleEngine;
+
+
 // Virtual console runs synchronously for audio and video in
 // pull mode.
 class VirtualConsole
@@ -72,6 +76,17 @@ public:
 		int64_t &length,
 		int &last_playback);
 
+// Put exit nodes which share modules or plugins in the same group.
+	void group_exit_nodes();
+// Render the exit nodes of every group concurrently.
+// The order of exit nodes in a group is preserved.
+	int render_groups();
+// Render the track of one exit node into its own buffer.  
+// Called by the engine.
+	virtual int render_exit_node(int number) { return 0; };
+// Bytes of the buffers kept for every exit node when rendering concurrently
+	virtual int64_t track_buffer_bytes() { return 0; };
+
 
 	RenderEngine *renderengine;
 	CommonRender *commonrender;
@@ -105,6 +120,13 @@ public:
 	int done;
 // Trace the rendering path of the tree
 	int debug_tree;
+// Group of each exit node.  Groups don't depend on each other.
+	ArrayList<int> exit_groups;
+	int total_groups;
+// Set when the groups are rendered concurrently.  Modules can't use
+// the temporaries in the CommonRender.
+	int render_parallel;
+	VirtualConsoleEngine *engine;
 
 
 
@@ -132,5 +154,37 @@ public:
 };
 
 
+class VirtualConsolePackage : public LoadPackage
+{
+public:
+	VirtualConsolePackage();
+
+	int group;
+	int result;
+};
+
+class VirtualConsoleUnit : public LoadClient
+{
+public:
+	VirtualConsoleUnit(VirtualConsoleEngine *engine);
+
+	void process_package(LoadPackage *package);
+
+	VirtualConsoleEngine *engine;
+};
+
+class VirtualConsoleEngine : public LoadServer
+{
+public:
+	VirtualConsoleEngine(VirtualConsole *vconsole, int cpus);
+
+	void init_packages();
+	LoadClient* new_client();
+	LoadPackage* new_package();
+
+	VirtualConsole *vconsole;
+};
+
+
 
 #endif
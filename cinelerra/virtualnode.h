@@ -79,6 +79,11 @@ public:
 // Called by read_data to get the previous plugin in a parent node's subnode
 // table.
 	VirtualNode* get_previous_plugin(VirtualNode *current_plugin);
+// Append the modules and attachment points used by this node and its subnodes.
+	void get_resources(ArrayList<void*> *resources);
+// Whether a subnode renders a module.  Module nodes composite into the
+// shared output so the tree can't be rendered concurrently.
+	int has_nested_module();
 
 // subnodes this node owns
 // was vplugins
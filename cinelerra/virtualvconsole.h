@@ -53,10 +53,18 @@ public:
 // start_position - start of buffer in project if forward. end of buffer if reverse
 	int process_buffer(int64_t input_position);
 
+// Render the track of an exit node into its entry in track_frames
+	int render_exit_node(int number);
+	int64_t track_buffer_bytes();
+
 // absolute frame the buffer starts on
 	int64_t absolute_frame;        
 
 	VFrame *output_temp;
+// Output of each exit node when the tracks are rendered concurrently
+	ArrayList<VFrame*> track_frames;
+// Position passed to process_buffer
+	int64_t input_position;
 	VRender *vrender;
 // Calculated at the start of every process_buffer
 	int use_opengl;
@@ -65,6 +65,20 @@ public:
 		double frame_rate,
 		int use_opengl);
 
+// The two halves of render for a module.  When tracks are rendered
+// concurrently, render_track runs in the VirtualConsoleEngine and the
+// tracks are composited in order afterwards.
+// Render the track with its effects, fade and mask into output_temp.
+	void render_track(VFrame *output_temp,
+		int64_t start_position,
+		double frame_rate,
+		int use_opengl);
+// Overlay output_temp on video_out.
+	void composite_track(VFrame *video_out,
+		VFrame *output_temp,
+		int64_t start_position,
+		double frame_rate);
+
 private:
 	int render_as_module(VFrame *video_out, 
 		VFrame *output_temp,
@@ -61,6 +61,9 @@ public:
 	int get_buffer_size();
 
 	CICache* get_cache();
+// Whether the temporaries in VRender can be used.  Tracks rendered 
+// concurrently need their own.
+	int use_vrender_temps();
 // Read frame from file and perform camera transformation
 	int import_frame(VFrame *output,
 		VEdit *current_edit,
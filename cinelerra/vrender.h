@@ -22,13 +22,59 @@
 #ifndef VRENDER_H
 #define VRENDER_H
 
+#include "arraylist.h"
 #include "commonrender.h"
+#include "condition.inc"
 #include "edit.inc"
+#include "framestore.inc"
 #include "guicast.h"
+#include "mutex.inc"
 #include "mwindow.inc"
 #include "overlayframe.inc"
 #include "renderengine.inc"
 #include "vframe.inc"
+#include "vrender.inc"
+
+
+// Writes frames to the video device at their time while VRender renders
+// the next ones.  Frames are displayed in the order they were sent.
+class VRenderDisplay : public Thread
+{
+public:
+	VRenderDisplay(VRender *vrender, int total_frames);
+	~VRenderDisplay();
+
+// Get a frame to render into.  Blocks until a frame has been displayed.
+	VFrame* get_frame(int colormodel);
+// Queue a rendered frame.  The first frame is held until the pipeline is full.
+	void send_frame(VFrame *frame, int64_t session_frame, int64_t position);
+// Display the queued frames and quit
+	void stop();
+	void run();
+// Whether the first frame is displayed and the sync position is running
+	int is_playing();
+
+	VRender *vrender;
+	RenderEngine *renderengine;
+
+private:
+	void display_frame(VFrame *frame, int64_t session_frame, int64_t position);
+
+// Written by the display thread under lock
+	int playing;
+
+	int total_frames;
+	int total_sent;
+	ArrayList<VFrame*> free_frames;
+	ArrayList<VFrame*> ready_frames;
+	ArrayList<int64_t> ready_session_frames;
+	ArrayList<int64_t> ready_positions;
+	Mutex *lock;
+	Condition *free_lock;
+	Condition *ready_lock;
+	Condition *preroll_lock;
+	Timer timer;
+};
 
 
 class VRender : public CommonRender
@@ -110,6 +156,10 @@ public:
 	VFrame *transition_temp;
 // Engine for camera and projector automation
 	OverlayFrame *overlayer;
+// Frames stored by the background renderer
+	FrameStore *frame_store;
+// Device writer when frames are pipelined
+	VRenderDisplay *display;
 
 
 	
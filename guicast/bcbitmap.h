@@ -34,7 +34,10 @@
 #include "vframe.inc"
 
 //#define BITMAP_RING 1
+// Default ring buffers for shared memory
 #define BITMAP_RING 4
+// Most ring buffers a bitmap can have
+#define BITMAP_MAX_RING 16
 
 class BC_Bitmap
 {
@@ -48,7 +51,8 @@ public:
 		int w, 
 		int h, 
 		int color_model, 
-		int use_shm = 1);
+		int use_shm = 1,
+		int ring_size = BITMAP_RING);
 	virtual ~BC_Bitmap();
 
 // transfer VFrame
@@ -68,8 +72,14 @@ public:
 
 // When showing the same frame twice need to rewind
 	void rewind_ring();
+// Advance to the next ring buffer without drawing
+	void next_ring();
+	int get_ring_buffers();
+	int get_current_ringbuffer();
 // If dont_wait is true, the XSync comes before the flash.
 // For YUV bitmaps, the image is scaled to fill dest_x ... w * dest_y ... h
+// If ringbuffer is >= 0, that ring buffer is drawn and the current ring buffer 
+// doesn't change, so another thread can fill the ring.
 	int write_drawable(Drawable &pixmap, 
 			GC &gc,
 			int source_x, 
@@ -80,7 +90,8 @@ public:
 			int dest_y, 
 			int dest_w, 
 			int dest_h, 
-			int dont_wait);
+			int dont_wait,
+			int ringbuffer = -1);
 	int write_drawable(Drawable &pixmap, 
 			GC &gc,
 			int dest_x, 
@@ -126,13 +137,20 @@ public:
 	int invert();
 
 private:
-	int initialize(BC_WindowBase *parent_window, int w, int h, int color_model, int use_shm);
+	int initialize(BC_WindowBase *parent_window, 
+		int w, 
+		int h, 
+		int color_model, 
+		int use_shm, 
+		int ring_size = BITMAP_RING);
 	int allocate_data();
 	int delete_data();
 	int get_default_depth();
 	char byte_bitswap(char src);
 
 	int ring_buffers, current_ringbuffer;
+// Ring buffers requested for shared memory
+	int ring_size;
 	int w, h;
 // Color model from colormodels.h
 	int color_model;
@@ -143,9 +161,9 @@ private:
 	BC_WindowBase *top_level;
 	BC_WindowBase *parent_window;
 // Points directly to the frame buffer
-	unsigned char *data[BITMAP_RING];   
+	unsigned char *data[BITMAP_MAX_RING];   
 // Row pointers to the frame buffer
-	unsigned char **row_data[BITMAP_RING];   
+	unsigned char **row_data[BITMAP_MAX_RING];   
 	int xv_portid;
 // This differs from the depth parameter of top_level
 	int bits_per_pixel;
@@ -161,8 +179,8 @@ private:
 // X11 objects
 // Need last pixmap to stop XVideo
 	Drawable last_pixmap;
-	XImage *ximage[BITMAP_RING];
-	XvImage *xv_image[BITMAP_RING];
+	XImage *ximage[BITMAP_MAX_RING];
+	XvImage *xv_image[BITMAP_MAX_RING];
 	XShmSegmentInfo shm_info;
 };
 
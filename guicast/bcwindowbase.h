@@ -486,7 +486,8 @@ public:
 		int src_y = 0,
 		int src_w = 0,
 		int src_h = 0,
-		BC_Pixmap *pixmap = 0);
+		BC_Pixmap *pixmap = 0,
+		int ringbuffer = -1);
 	void draw_pixel(int x, int y, BC_Pixmap *pixmap = 0);
 // Draw a pixmap on the window
 	void draw_pixmap(BC_Pixmap *pixmap, 
@@ -101,6 +101,9 @@ public:
 
 // direct copy with no alpha
 	int copy_from(VFrame *frame);
+// Exchange image buffers with an equivalent frame.  Neither frame may be shared.
+// Returns 1 if the buffers can't be exchanged.
+	int swap_data(VFrame *frame);
 // Required for YUV
 	int clear_frame();
 	int allocate_compressed_data(long bytes);
@@ -7,7 +7,7 @@
 
 
 
-static pthread_mutex_t *decode_lock = 0;
+static pthread_mutex_t decode_lock = PTHREAD_MUTEX_INITIALIZER;
 
 
 static void toc_error()
@@ -218,7 +218,7 @@ static int read_frame(mpeg3audio_t *audio, int render)
 // Liba52 is not reentrant
 	if(track->format == AUDIO_AC3)
 	{
-		pthread_mutex_lock(decode_lock);
+		pthread_mutex_lock(&decode_lock);
 	}
 
 /* Find and read next header */
@@ -322,7 +322,7 @@ static int read_frame(mpeg3audio_t *audio, int render)
 // Liba52 is not reentrant
 	if(track->format == AUDIO_AC3)
 	{
-		pthread_mutex_unlock(decode_lock);
+		pthread_mutex_unlock(&decode_lock);
 	}
 
 
@@ -445,14 +445,6 @@ mpeg3audio_t* mpeg3audio_new(mpeg3_t *file,
 	int result = 0;
 	int i;
 
-	if(!decode_lock)
-	{
-		pthread_mutexattr_t attr;
-		pthread_mutexattr_init(&attr);
-		decode_lock = calloc(1, sizeof(pthread_mutex_t));
-		pthread_mutex_init(decode_lock, &attr);
-	}
-
 	audio->file = file;
 	audio->track = track;
 
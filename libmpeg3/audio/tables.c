@@ -3,6 +3,7 @@
 #include "tables.h"
 
 #include <math.h>
+#include <pthread.h>
 
 /* Bitrate indexes */
 int mpeg3_tabsel_123[2][3][16] = {
@@ -187,10 +188,6 @@ static int init_layer3(mpeg3_layer_t *audio)
 	int i, j, k, l;
 	int down_sample_sblimit = 32;
 
-	audio->mp3_block[0][0][0] = 0;
-	audio->mp3_blc[0] = 0;
-	audio->mp3_blc[1] = 0;
-
 	for(i = -256; i < 118 + 4; i++)
 	  	mpeg3_gainpow2[i + 256] = pow((double)2.0, -0.25 * (double)(i + 210));
 
@@ -412,13 +409,28 @@ static int init_layer3(mpeg3_layer_t *audio)
 	return 0;
 }
 
+/* The tables are shared by every decoder but decoders are created by */
+/* several threads when a table of contents is built. */
+static pthread_mutex_t tables_lock = PTHREAD_MUTEX_INITIALIZER;
+static int tables_initialized = 0;
+
 int mpeg3_new_decode_tables(mpeg3_layer_t *audio)
 {
 	int i, j, k, kr, divv;
 	float *costab;
 	int idx;
 	long scaleval = 1;
-	
+
+	audio->mp3_block[0][0][0] = 0;
+	audio->mp3_blc[0] = 0;
+	audio->mp3_blc[1] = 0;
+
+	pthread_mutex_lock(&tables_lock);
+	if(tables_initialized)
+	{
+		pthread_mutex_unlock(&tables_lock);
+		return 0;
+	}
   
 	for(i = 0; i < 5; i++)
 	{
@@ -475,5 +487,7 @@ int mpeg3_new_decode_tables(mpeg3_layer_t *audio)
 /* Initialize MPEG */
 	init_layer2(audio); /* inits also shared tables with layer1 */
 	init_layer3(audio);
+	tables_initialized = 1;
+	pthread_mutex_unlock(&tables_lock);
 	return 0;
 }
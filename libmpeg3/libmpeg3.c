@@ -61,6 +61,8 @@ int mpeg3_delete(mpeg3_t *file)
 const int debug = 0;
 
 if(debug) printf("mpeg3_delete 1\n");
+	if(file->toc_scan) mpeg3_delete_tocscan(file->toc_scan);
+
 	for(i = 0; i < file->total_vstreams; i++)
 		mpeg3_delete_vtrack(file, file->vtrack[i]);
 if(debug) printf("mpeg3_delete 2\n");
@@ -564,6 +566,14 @@ int mpeg3_set_cpus(mpeg3_t *file, int cpus)
 	return 0;
 }
 
+int mpeg3_set_cache_size(mpeg3_t *file, int64_t bytes)
+{
+	int i;
+	for(i = 0; i < file->total_vstreams; i++)
+		mpeg3_cache_set_size(file->vtrack[i]->frame_cache, bytes);
+	return 0;
+}
+
 int mpeg3_has_audio(mpeg3_t *file)
 {
 	return file->total_astreams > 0;
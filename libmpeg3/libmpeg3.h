@@ -59,6 +59,8 @@ int mpeg3_close(mpeg3_t *file);
 
 /* Performance */
 int mpeg3_set_cpus(mpeg3_t *file, int cpus);
+/* Bytes of decoded frames to cache for every video stream */
+int mpeg3_set_cache_size(mpeg3_t *file, int64_t bytes);
 
 /* Query the MPEG3 stream about audio. */
 int mpeg3_has_audio(mpeg3_t *file);
@@ -229,13 +231,18 @@ void mpeg3_show_subtitle(mpeg3_t *file, int track);
 
 /* Table of contents generation */
 /* Begin constructing table of contents */
+/* Large files are scanned in segments by mpeg3_set_cpus threads. */
+/* The finished segments are kept in <toc_path>.part until the table */
+/* of contents is written, so an interrupted scan continues from there. */
 mpeg3_t* mpeg3_start_toc(char *path, char *toc_path, int64_t *total_bytes);
 /* Set the maximum number of bytes per index track */
 void mpeg3_set_index_bytes(mpeg3_t *file, int64_t bytes);
-/* Process one packet */
+/* Process one packet or wait for the segment threads. */
+/* Returns 1 if a segment couldn't be scanned. */
 int mpeg3_do_toc(mpeg3_t *file, int64_t *bytes_processed);
-/* Write table of contents */
-void mpeg3_stop_toc(mpeg3_t *file);
+/* Write table of contents.  Nothing is written and 1 is returned if the */
+/* segments are unfinished. */
+int mpeg3_stop_toc(mpeg3_t *file);
 
 /* Get modification date of source file from table of contents. */
 /* Used to compare DVD source file to table of contents source. */
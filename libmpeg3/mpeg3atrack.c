@@ -56,6 +56,7 @@ int mpeg3_delete_atrack(mpeg3_t *file, mpeg3_atrack_t *atrack)
 	{
 		free(atrack->sample_offsets);
 	}
+	if(atrack->toc_packets) free(atrack->toc_packets);
 	free(atrack);
 	return 0;
 }
@@ -74,6 +75,30 @@ void mpeg3_append_samples(mpeg3_atrack_t *atrack, int64_t offset)
 	atrack->private_offsets = 1;
 }
 
+void mpeg3_append_toc_packet(mpeg3_atrack_t *atrack, int64_t offset)
+{
+	int64_t samples = atrack->current_position + atrack->audio->output_size;
+	mpeg3_tocpacket_t *packet;
+
+// Only packets which completed samples can start a chunk
+	if(atrack->total_toc_packets &&
+		atrack->toc_packets[atrack->total_toc_packets - 1].samples == samples)
+		return;
+
+	if(atrack->total_toc_packets >= atrack->toc_packets_allocated)
+	{
+		atrack->toc_packets_allocated = 
+			MAX(atrack->total_toc_packets * 2, 1024);
+		atrack->toc_packets = realloc(atrack->toc_packets,
+			sizeof(mpeg3_tocpacket_t) * atrack->toc_packets_allocated);
+	}
+
+	packet = &atrack->toc_packets[atrack->total_toc_packets++];
+	packet->offset = offset;
+	packet->prev_offset = atrack->prev_offset;
+	packet->samples = samples;
+}
+
 
 
 
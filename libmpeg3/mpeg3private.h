@@ -77,6 +77,11 @@
 #define MPEG3_AUDIO_HISTORY              0x100000 
 /* Range to scan for pts after byte seek */
 #define MPEG3_PTS_RANGE                  0x100000 
+/* Bytes in every segment scanned in parallel when building a table of contents */
+#define MPEG3_TOC_SEGMENT                0x10000000
+/* Bytes a segment scan continues into the next segment to resynchronize */
+#define MPEG3_TOC_OVERLAP                0x1000000
+#define MPEG3_TOC_PROGRESS_PREFIX        0x544f4350
 
 /* Values for audio format */
 #define AUDIO_UNKNOWN 0
@@ -694,6 +699,14 @@ typedef struct
 	int index_zoom;
 } mpeg3_index_t;
 
+/* Audio packet which decoded samples while scanning a segment */
+typedef struct
+{
+	int64_t offset;           /* Start of the packet */
+	int64_t prev_offset;      /* Start of the previous packet in the track */
+	int64_t samples;          /* Samples decoded after the packet */
+} mpeg3_tocpacket_t;
+
 
 
 typedef struct
@@ -727,7 +740,10 @@ typedef struct
 
 /* Starting byte of previous packet for making TOC */
 	int64_t prev_offset;
-
+/* Packets which decoded samples if scanning a segment of the TOC */
+	mpeg3_tocpacket_t *toc_packets;
+	int total_toc_packets;
+	int toc_packets_allocated;
 } mpeg3_atrack_t;
 
 
@@ -862,22 +878,55 @@ typedef struct
 
 
 
-typedef struct
+typedef struct mpeg3_cacheframe_s
 {
 	unsigned char *y, *u, *v;
 	int y_size;
 	int u_size;
 	int v_size;
 	int64_t frame_number;
+/* One reference from the cache and one from every reader using the planes */
+	int refcount;
+	struct mpeg3_cacheframe_s *hash_next;
+/* Neighbors in the order of use.  next is older. */
+	struct mpeg3_cacheframe_s *lru_prev, *lru_next;
 } mpeg3_cacheframe_t;
 
+/* Must be a power of 2 */
+#define MPEG3_CACHE_HASH 64
+/* Enough for a full 1080 GOP */
+#define MPEG3_CACHE_BYTES 0x4000000
+
 typedef struct
 {
-	mpeg3_cacheframe_t *frames;
+	mpeg3_cacheframe_t *hash[MPEG3_CACHE_HASH];
+/* Most recently and least recently used frames */
+	mpeg3_cacheframe_t *newest, *oldest;
 	int total;
-	int allocation;
+/* Bytes in planes held by the cache */
+	int64_t usage;
+	int64_t max_usage;
+/* Frames are stored by the GOP decoders while the track is read */
+	pthread_mutex_t lock;
 } mpeg3_cache_t;
 
+/* Upper limit when the cache grows to hold the GOPs being decoded ahead */
+#define MPEG3_GOP_CACHE_BYTES 0x20000000
+
+/* Decodes a whole GOP of a sequentially read track on its own thread */
+typedef struct
+{
+	void *video;         /* mpeg3video_t being read */
+	void *track;         /* Private mpeg3_vtrack_t of this decoder */
+	int number;          /* Number of the video stream */
+	int start_frame;     /* First frame of the GOP */
+	int end_frame;       /* Frame after the GOP */
+	int busy;            /* completion_lock must be taken before the next GOP */
+	int done;
+	pthread_t tid;
+	pthread_mutex_t input_lock, completion_lock;
+} mpeg3_gop_t;
+
 
 typedef struct
 {
@@ -897,6 +946,11 @@ typedef struct
 
 	mpeg3_slice_t slice_decoders[MPEG3_MAX_CPUS];  /* One slice decoder for every CPU */
 	int total_slice_decoders;                       /* Total slice decoders in use */
+	int cpus;                        /* Slice decoders to use */
+	mpeg3_gop_t *gop_decoders;       /* Decode the following GOPs on sequential reads */
+	int total_gop_decoders;
+	int gop_frame;                   /* Frame after the last read if reading sequentially */
+	int gop_scheduled;               /* Frame after the last GOP given to a decoder */
 	mpeg3_slice_buffer_t slice_buffers[MPEG3_MAX_CPUS];   /* Buffers for holding the slice data */
 	int total_slice_buffers;         /* Total buffers in the array to be decompressed */
 	int slice_buffers_initialized;     /* Total buffers initialized in the array */
@@ -930,6 +984,8 @@ typedef struct
 	unsigned char *mpeg3_alternate_scan_table;
 // Source for the next frame presentation
 	unsigned char *output_src[3];
+/* Cached frame handed out by mpeg3video_read_yuvframe_ptr */
+	mpeg3_cacheframe_t *cache_frame;
 /* Pointers to frame buffers. */
 	unsigned char *newframe[3];
 	int horizontal_size, vertical_size, mb_width, mb_height;
@@ -1057,6 +1113,84 @@ typedef struct
 
 
 
+/* Tracks found in a segment of a table of contents. */
+/* The offsets are absolute but sample and frame numbers start */
+/* at the start of the segment. */
+typedef struct
+{
+	unsigned int pid;
+	int channels;
+	int64_t audio_eof;
+	int64_t first_offset;     /* Start of the first packet */
+	int64_t last_offset;      /* Start of the last packet */
+	int64_t total_samples;
+	mpeg3_tocpacket_t *packets;
+	int total_packets;
+	mpeg3_index_t *index;
+} mpeg3_tocaudio_t;
+
+typedef struct
+{
+	unsigned int pid;
+	int64_t video_eof;
+	int64_t *frame_offsets;
+	unsigned char *keyframes; /* 1 if the frame is a keyframe */
+	int total_frames;
+} mpeg3_tocvideo_t;
+
+typedef struct
+{
+	int id;
+	int64_t *offsets;
+	int total_offsets;
+} mpeg3_tocsubtitle_t;
+
+typedef struct
+{
+	int64_t start_byte;
+	int64_t end_byte;         /* Start of the next segment */
+	int64_t bytes_processed;
+	int busy;                 /* Taken by a thread */
+	int done;                 /* Results are complete */
+/* STREAM_AUDIO or STREAM_VIDEO, stream ID and table value for every stream */
+	int *streams;
+	int total_streams;
+	mpeg3_tocaudio_t *audio;
+	int total_audio;
+	mpeg3_tocvideo_t *video;
+	int total_video;
+	mpeg3_tocsubtitle_t *subtitles;
+	int total_subtitles;
+} mpeg3_tocsegment_t;
+
+/* Table of contents of a large file built from segments scanned in parallel. */
+/* Finished segments are saved in the progress file so an interrupted scan */
+/* continues where it left off. */
+typedef struct
+{
+	char path[MPEG3_STRLEN];
+	char progress_path[MPEG3_STRLEN];
+	FILE *progress_fd;
+	int64_t source_date;
+	int64_t total_bytes;
+	int64_t index_bytes;
+	mpeg3_tocsegment_t *segments;
+	int total_segments;
+	pthread_t *threads;
+	int total_threads;
+	int interrupted;
+/* A segment couldn't be scanned.  It stays unfinished for the next attempt. */
+	int error;
+	pthread_mutex_t lock;
+} mpeg3_tocscan_t;
+
+
+
+
+
+
+
+
 // Whole thing
 typedef struct
 {
@@ -1120,6 +1254,10 @@ typedef struct
 
 /* For building TOC, the output file. */
 	FILE *toc_fd;
+/* Segments scanned in parallel when building the TOC of a large file */
+	mpeg3_tocscan_t *toc_scan;
+/* Scanning one of those segments */
+	int toc_segment;
 
 /*
  * After byte seeking is called, this is set to -1.
@@ -51,6 +51,8 @@ mpeg3_atrack_t* mpeg3_new_atrack(mpeg3_t *file,
 int mpeg3_delete_atrack(mpeg3_t *file, mpeg3_atrack_t *atrack);
 
 void mpeg3_append_samples(mpeg3_atrack_t *atrack, int64_t offset);
+/* Store the samples decoded after a packet when scanning a TOC segment */
+void mpeg3_append_toc_packet(mpeg3_atrack_t *atrack, int64_t offset);
 
 
 /* These return 1 on failure and 0 on success */
@@ -249,6 +251,15 @@ int mpeg3_read_yuvframe(mpeg3_t *file,
 // cache_it - store dropped frames in cache
 int mpeg3video_drop_frames(mpeg3video_t *video, long frames, int cache_it);
 void mpeg3_decode_subtitle(mpeg3video_t *video);
+int mpeg3video_seek(mpeg3video_t *video);
+int mpeg3video_read_frame_backend(mpeg3video_t *video, int skip_bframes);
+int mpeg3video_set_cpus(mpeg3video_t *video, int cpus);
+// Decode the GOPs after frame_number on other threads if the reads are sequential
+// and wait for the GOP containing frame_number.
+void mpeg3video_schedule_gops(mpeg3video_t *video, int frame_number);
+// Wait for all the GOPs being decoded
+void mpeg3video_wait_gops(mpeg3video_t *video);
+void mpeg3video_delete_gops(mpeg3video_t *video);
 
 
 
@@ -273,15 +284,17 @@ void mpeg3_cache_put_frame(mpeg3_cache_t *ptr,
 	int y_size,
 	int u_size,
 	int v_size);
-// Return 1 if the frame was found.
-int mpeg3_cache_get_frame(mpeg3_cache_t *ptr,
-	int64_t frame_number,
-	unsigned char **y,
-	unsigned char **u,
-	unsigned char **v);
-int mpeg3_ceche_has_frame(mpeg3_cache_t *ptr,
+// Return a reference to the frame or 0 if it wasn't found.
+// The planes stay valid until the reference is released.
+mpeg3_cacheframe_t* mpeg3_cache_get_frame(mpeg3_cache_t *ptr,
+	int64_t frame_number);
+void mpeg3_cache_release_frame(mpeg3_cache_t *ptr, mpeg3_cacheframe_t *frame);
+int mpeg3_cache_has_frame(mpeg3_cache_t *ptr,
 	int64_t frame_number);
 int64_t mpeg3_cache_usage(mpeg3_cache_t *ptr);
+// Limit the bytes held by the cache, deleting the least recently used frames
+void mpeg3_cache_set_size(mpeg3_cache_t *ptr, int64_t bytes);
+int64_t mpeg3_cache_get_size(mpeg3_cache_t *ptr);
 
 
 
@@ -321,6 +334,24 @@ int mpeg3_get_file_type(mpeg3_t *file,
 	int *toc_vtracks);
 
 int mpeg3_read_toc(mpeg3_t *file, int *atracks_return, int *vtracks_return);
+/* Open the source of a table of contents for scanning from the start. */
+mpeg3_t* mpeg3_open_toc_source(char *path);
+/* Count the samples left in the audio tracks after the last packet */
+void mpeg3_flush_toc(mpeg3_t *file);
+/* Halve the size of an index */
+void mpeg3_divide_index(mpeg3_index_t *index);
+
+/* TOC SEGMENTS */
+/* Returns 0 if the segment table or progress file can't be created */
+mpeg3_tocscan_t* mpeg3_new_tocscan(mpeg3_t *file, char *toc_path, int64_t total_bytes);
+/* Stops the threads.  The finished segments stay in the progress file. */
+void mpeg3_delete_tocscan(mpeg3_tocscan_t *scan);
+/* Starts the threads on the first call and gets the bytes scanned. */
+/* Returns 1 if a segment couldn't be scanned. */
+int mpeg3_do_tocscan(mpeg3_t *file, int64_t *bytes_processed);
+/* Create the tracks of the table of contents from the segments. */
+/* Returns 1 if the segments aren't finished. */
+int mpeg3_merge_tocscan(mpeg3_t *file);
 
 
 
@@ -11,6 +11,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <unistd.h>
 
 
 
@@ -21,6 +22,7 @@ int main(int argc, char *argv[])
 	int i, j, l;
 	char *src = 0, *dst = 0;
 	int verbose = 0;
+	int cpus = sysconf(_SC_NPROCESSORS_ONLN);
 
 	if(argc < 3)
 	{
@@ -30,6 +32,7 @@ int main(int argc, char *argv[])
 			"Usage: mpeg3cvtoc <path> <output>\n"
 			"\n"
 			"-v Print tracking information\n"
+			"-c <cpus> Threads for scanning large files\n"
 			"\n"
 			"The path should be absolute unless you plan\n"
 			"to always run your movie editor from the same directory\n"
@@ -50,6 +53,11 @@ int main(int argc, char *argv[])
 			verbose = 1;
 		}
 		else
+		if(!strcmp(argv[i], "-c") && i < argc - 1)
+		{
+			cpus = atoi(argv[++i]);
+		}
+		else
 		if(argv[i][0] == '-')
 		{
 			fprintf(stderr, "Unrecognized command %s\n", argv[i]);
@@ -88,6 +96,7 @@ int main(int argc, char *argv[])
 	int64_t total_bytes;
 	mpeg3_t *file = mpeg3_start_toc(src, dst, &total_bytes);
 	if(!file) exit(1);
+	mpeg3_set_cpus(file, cpus);
 	struct timeval new_time;
 	struct timeval prev_time;
 	struct timeval start_time;
@@ -99,14 +108,16 @@ int main(int argc, char *argv[])
 	while(1)
 	{
 		int64_t bytes_processed = 0;
-		mpeg3_do_toc(file, &bytes_processed);
+		if(mpeg3_do_toc(file, &bytes_processed)) break;
 
 		gettimeofday(&new_time, 0);
 		if(verbose && new_time.tv_sec - prev_time.tv_sec > 1)
 		{
 			gettimeofday(&current_time, 0);
 			int64_t elapsed_seconds = current_time.tv_sec - start_time.tv_sec;
-			int64_t total_seconds = elapsed_seconds * total_bytes / bytes_processed;
+			int64_t total_seconds = bytes_processed ? 
+				elapsed_seconds * total_bytes / bytes_processed : 
+				0;
 			int64_t eta = total_seconds - elapsed_seconds;
 			fprintf(stderr, "%" PRId64 "%% ETA: %" PRId64 "m%" PRId64 "s        \r",
 				bytes_processed * 100 / total_bytes,
@@ -119,7 +130,12 @@ int main(int argc, char *argv[])
 		if(bytes_processed >= total_bytes) break;
 	}
 
-	mpeg3_stop_toc(file);
+	if(mpeg3_stop_toc(file))
+	{
+		fprintf(stderr, "Couldn't create the table of contents.\n");
+		remove(dst);
+		exit(1);
+	}
 	gettimeofday(&current_time, 0);
 	int64_t elapsed = current_time.tv_sec - start_time.tv_sec;
 	if(verbose)
@@ -0,0 +1,966 @@
+#include "libmpeg3.h"
+#include "mpeg3private.h"
+#include "mpeg3protos.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+
+// Tables of contents of large files are built from segments scanned by
+// several threads, each with its own mpeg3_t.  A segment is scanned
+// MPEG3_TOC_OVERLAP bytes into the next segment.  Halfway through the overlap
+// the next segment's demuxer & decoders are synchronized, so the tracks of
+// both segments are joined there.  Every finished segment is appended to a
+// progress file next to the table of contents, so an interrupted scan
+// continues with the unfinished segments.
+
+
+typedef struct
+{
+	unsigned char *buffer;
+	int64_t size;
+	int64_t position;
+	int error;
+} progress_t;
+
+
+static int64_t segment_bytes(mpeg3_tocsegment_t *segment)
+{
+	return segment->end_byte - segment->start_byte;
+}
+
+// Offset where a segment stops contributing packets and the next one starts
+static int64_t cut_offset(mpeg3_tocscan_t *scan, int number)
+{
+	if(number < 0) return 0;
+	if(number >= scan->total_segments - 1) return 0x7fffffffffffffffLL;
+	return scan->segments[number].end_byte + MPEG3_TOC_OVERLAP / 2;
+}
+
+static void put_int32(FILE *fd, uint32_t x)
+{
+	fputc((x >> 24) & 0xff, fd);
+	fputc((x >> 16) & 0xff, fd);
+	fputc((x >> 8) & 0xff, fd);
+	fputc(x & 0xff, fd);
+}
+
+static void put_int64(FILE *fd, uint64_t x)
+{
+	put_int32(fd, x >> 32);
+	put_int32(fd, x);
+}
+
+static int get_data(progress_t *progress, void *data, int64_t bytes)
+{
+	if(bytes < 0 || bytes > progress->size - progress->position)
+	{
+		progress->error = 1;
+		return 1;
+	}
+
+	if(data) memcpy(data, progress->buffer + progress->position, bytes);
+	progress->position += bytes;
+	return 0;
+}
+
+static uint32_t get_int32(progress_t *progress)
+{
+	unsigned char *ptr;
+	if(get_data(progress, 0, 4)) return 0;
+	ptr = progress->buffer + progress->position - 4;
+	return ((uint32_t)ptr[0] << 24) |
+		((uint32_t)ptr[1] << 16) |
+		((uint32_t)ptr[2] << 8) |
+		(uint32_t)ptr[3];
+}
+
+static uint64_t get_int64(progress_t *progress)
+{
+	uint64_t high = get_int32(progress);
+	return (high << 32) | get_int32(progress);
+}
+
+// Allocate an array for a count read from the file.  The count can't
+// exceed the data left in the file.
+static void* get_array(progress_t *progress, int64_t count, int size)
+{
+	if(progress->error ||
+		count < 0 ||
+		count * size > progress->size - progress->position)
+	{
+		progress->error = 1;
+		return 0;
+	}
+	return calloc(count ? count : 1, size);
+}
+
+
+static void clear_segment(mpeg3_tocsegment_t *segment)
+{
+	int i;
+	for(i = 0; i < segment->total_audio; i++)
+	{
+		mpeg3_tocaudio_t *audio = &segment->audio[i];
+		if(audio->packets) free(audio->packets);
+		if(audio->index) mpeg3_delete_index(audio->index);
+	}
+
+	for(i = 0; i < segment->total_video; i++)
+	{
+		mpeg3_tocvideo_t *video = &segment->video[i];
+		if(video->frame_offsets) free(video->frame_offsets);
+		if(video->keyframes) free(video->keyframes);
+	}
+
+	for(i = 0; i < segment->total_subtitles; i++)
+	{
+		if(segment->subtitles[i].offsets) free(segment->subtitles[i].offsets);
+	}
+
+	if(segment->streams) free(segment->streams);
+	if(segment->audio) free(segment->audio);
+	if(segment->video) free(segment->video);
+	if(segment->subtitles) free(segment->subtitles);
+	segment->streams = 0;
+	segment->total_streams = 0;
+	segment->audio = 0;
+	segment->total_audio = 0;
+	segment->video = 0;
+	segment->total_video = 0;
+	segment->subtitles = 0;
+	segment->total_subtitles = 0;
+	segment->done = 0;
+}
+
+static void append_stream(mpeg3_tocsegment_t *segment, int type, int id, int value)
+{
+	int *stream;
+	segment->streams = realloc(segment->streams,
+		sizeof(int) * 3 * (segment->total_streams + 1));
+	stream = segment->streams + segment->total_streams * 3;
+	stream[0] = type;
+	stream[1] = id;
+	stream[2] = value;
+	segment->total_streams++;
+}
+
+// Move the tracks of a scanned segment into the segment table
+static void take_tracks(mpeg3_tocsegment_t *segment, mpeg3_t *file)
+{
+	int i, j;
+
+	for(i = 0; i < MPEG3_MAX_STREAMS; i++)
+	{
+		if(file->demuxer->astream_table[i])
+			append_stream(segment, STREAM_AUDIO, i, file->demuxer->astream_table[i]);
+		if(file->demuxer->vstream_table[i])
+			append_stream(segment, STREAM_VIDEO, i, file->demuxer->vstream_table[i]);
+	}
+
+	segment->audio = calloc(MAX(file->total_astreams, 1), sizeof(mpeg3_tocaudio_t));
+	segment->total_audio = file->total_astreams;
+	for(i = 0; i < file->total_astreams; i++)
+	{
+		mpeg3_atrack_t *atrack = file->atrack[i];
+		mpeg3_tocaudio_t *audio = &segment->audio[i];
+		audio->pid = atrack->pid;
+		audio->channels = atrack->channels;
+		audio->audio_eof = atrack->audio_eof;
+		audio->first_offset = atrack->sample_offsets[0];
+		audio->last_offset = atrack->prev_offset;
+		audio->total_samples = atrack->current_position;
+		audio->packets = atrack->toc_packets;
+		audio->total_packets = atrack->total_toc_packets;
+		atrack->toc_packets = 0;
+		audio->index = file->indexes[i];
+		file->indexes[i] = mpeg3_new_index();
+	}
+
+	segment->video = calloc(MAX(file->total_vstreams, 1), sizeof(mpeg3_tocvideo_t));
+	segment->total_video = file->total_vstreams;
+	for(i = 0; i < file->total_vstreams; i++)
+	{
+		mpeg3_vtrack_t *vtrack = file->vtrack[i];
+		mpeg3_tocvideo_t *video = &segment->video[i];
+		int zeros = 0;
+		video->pid = vtrack->pid;
+		video->video_eof = vtrack->video_eof;
+		video->frame_offsets = vtrack->frame_offsets;
+		video->total_frames = vtrack->total_frame_offsets;
+		video->keyframes = calloc(MAX(video->total_frames, 1), 1);
+		vtrack->frame_offsets = 0;
+
+// Keyframe numbers are 1 less than the frame offsets of the keyframes.
+// The first frame offset is always a keyframe.
+		for(j = 0; j < vtrack->total_keyframe_numbers; j++)
+		{
+			int64_t frame = vtrack->keyframe_numbers[j];
+			if(frame == 0)
+				frame = zeros++ ? 1 : 0;
+			else
+				frame++;
+			if(frame < video->total_frames) video->keyframes[frame] = 1;
+		}
+	}
+
+	segment->subtitles = calloc(MAX(file->total_sstreams, 1), sizeof(mpeg3_tocsubtitle_t));
+	segment->total_subtitles = file->total_sstreams;
+	for(i = 0; i < file->total_sstreams; i++)
+	{
+		mpeg3_strack_t *strack = file->strack[i];
+		mpeg3_tocsubtitle_t *subtitle = &segment->subtitles[i];
+		subtitle->id = strack->id;
+		subtitle->offsets = strack->offsets;
+		subtitle->total_offsets = strack->total_offsets;
+		strack->offsets = 0;
+	}
+}
+
+static void write_header(mpeg3_tocscan_t *scan)
+{
+	FILE *fd = scan->progress_fd;
+	put_int32(fd, MPEG3_TOC_PROGRESS_PREFIX);
+	put_int32(fd, MPEG3_TOC_VERSION);
+	put_int64(fd, scan->source_date);
+	put_int64(fd, scan->total_bytes);
+	put_int64(fd, MPEG3_TOC_SEGMENT);
+	fflush(fd);
+}
+
+static void write_segment(mpeg3_tocscan_t *scan, mpeg3_tocsegment_t *segment)
+{
+	FILE *fd = scan->progress_fd;
+	int i, j;
+
+	put_int32(fd, segment - scan->segments);
+
+	put_int32(fd, segment->total_streams);
+	for(i = 0; i < segment->total_streams * 3; i++)
+		put_int32(fd, segment->streams[i]);
+
+	put_int32(fd, segment->total_audio);
+	for(i = 0; i < segment->total_audio; i++)
+	{
+		mpeg3_tocaudio_t *audio = &segment->audio[i];
+		mpeg3_index_t *index = audio->index;
+		put_int32(fd, audio->pid);
+		put_int32(fd, audio->channels);
+		put_int64(fd, audio->audio_eof);
+		put_int64(fd, audio->first_offset);
+		put_int64(fd, audio->last_offset);
+		put_int64(fd, audio->total_samples);
+		put_int32(fd, audio->total_packets);
+		for(j = 0; j < audio->total_packets; j++)
+		{
+			put_int64(fd, audio->packets[j].offset);
+			put_int64(fd, audio->packets[j].prev_offset);
+			put_int64(fd, audio->packets[j].samples);
+		}
+
+		if(index->index_data)
+		{
+			put_int32(fd, index->index_size);
+			put_int32(fd, index->index_zoom);
+			put_int32(fd, index->index_channels);
+			for(j = 0; j < index->index_channels; j++)
+			{
+				fwrite(index->index_data[j],
+					sizeof(float) * 2,
+					index->index_size,
+					fd);
+			}
+		}
+		else
+		{
+			put_int32(fd, 0);
+			put_int32(fd, 1);
+			put_int32(fd, 0);
+		}
+	}
+
+	put_int32(fd, segment->total_video);
+	for(i = 0; i < segment->total_video; i++)
+	{
+		mpeg3_tocvideo_t *video = &segment->video[i];
+		put_int32(fd, video->pid);
+		put_int64(fd, video->video_eof);
+		put_int32(fd, video->total_frames);
+		for(j = 0; j < video->total_frames; j++)
+			put_int64(fd, video->frame_offsets[j]);
+		fwrite(video->keyframes, 1, video->total_frames, fd);
+	}
+
+	put_int32(fd, segment->total_subtitles);
+	for(i = 0; i < segment->total_subtitles; i++)
+	{
+		mpeg3_tocsubtitle_t *subtitle = &segment->subtitles[i];
+		put_int32(fd, subtitle->id);
+		put_int32(fd, subtitle->total_offsets);
+		for(j = 0; j < subtitle->total_offsets; j++)
+			put_int64(fd, subtitle->offsets[j]);
+	}
+
+// A segment without this was being written when the scan was interrupted
+	put_int32(fd, MPEG3_TOC_PROGRESS_PREFIX);
+	fflush(fd);
+}
+
+static void read_audio(progress_t *progress, mpeg3_tocaudio_t *audio)
+{
+	mpeg3_index_t *index;
+	int i, total, size, zoom, channels;
+
+	audio->pid = get_int32(progress);
+	audio->channels = get_int32(progress);
+	audio->audio_eof = get_int64(progress);
+	audio->first_offset = get_int64(progress);
+	audio->last_offset = get_int64(progress);
+	audio->total_samples = get_int64(progress);
+
+	total = get_int32(progress);
+	if(!(audio->packets = get_array(progress, total, sizeof(mpeg3_tocpacket_t))))
+		return;
+	audio->total_packets = total;
+	for(i = 0; i < total; i++)
+	{
+		audio->packets[i].offset = get_int64(progress);
+		audio->packets[i].prev_offset = get_int64(progress);
+		audio->packets[i].samples = get_int64(progress);
+	}
+
+	index = audio->index = mpeg3_new_index();
+	size = get_int32(progress);
+	zoom = get_int32(progress);
+	channels = get_int32(progress);
+	if(progress->error || size < 0 || zoom < 1 || channels < 0)
+	{
+		progress->error = 1;
+		return;
+	}
+
+	index->index_zoom = zoom;
+	if(size && channels)
+	{
+		if(!(index->index_data = get_array(progress, channels, sizeof(float*))))
+			return;
+		index->index_channels = channels;
+		for(i = 0; i < channels; i++)
+		{
+			if(!(index->index_data[i] = get_array(progress,
+				(int64_t)size * 2,
+				sizeof(float))))
+				return;
+			get_data(progress, index->index_data[i], sizeof(float) * 2 * size);
+		}
+		index->index_size = size;
+		index->index_allocated = size;
+	}
+}
+
+static void read_video(progress_t *progress, mpeg3_tocvideo_t *video)
+{
+	int i, total;
+
+	video->pid = get_int32(progress);
+	video->video_eof = get_int64(progress);
+
+	total = get_int32(progress);
+	if(!(video->frame_offsets = get_array(progress, total, sizeof(int64_t))))
+		return;
+	video->total_frames = total;
+	for(i = 0; i < total; i++)
+		video->frame_offsets[i] = get_int64(progress);
+
+	if(!(video->keyframes = get_array(progress, total, 1)))
+		return;
+	get_data(progress, video->keyframes, total);
+}
+
+static void read_subtitle(progress_t *progress, mpeg3_tocsubtitle_t *subtitle)
+{
+	int i, total;
+
+	subtitle->id = get_int32(progress);
+	total = get_int32(progress);
+	if(!(subtitle->offsets = get_array(progress, total, sizeof(int64_t))))
+		return;
+	subtitle->total_offsets = total;
+	for(i = 0; i < total; i++)
+		subtitle->offsets[i] = get_int64(progress);
+}
+
+// Returns 1 if the segment is incomplete
+static int read_segment(mpeg3_tocscan_t *scan, progress_t *progress)
+{
+	mpeg3_tocsegment_t *segment;
+	int i, total;
+	int number = get_int32(progress);
+
+	if(progress->error ||
+		number < 0 ||
+		number >= scan->total_segments ||
+		scan->segments[number].done)
+		return 1;
+	segment = &scan->segments[number];
+
+	total = get_int32(progress);
+	if((segment->streams = get_array(progress, (int64_t)total * 3, sizeof(int))))
+	{
+		segment->total_streams = total;
+		for(i = 0; i < total * 3; i++)
+			segment->streams[i] = get_int32(progress);
+	}
+
+	total = get_int32(progress);
+	if((segment->audio = get_array(progress, total, sizeof(mpeg3_tocaudio_t))))
+	{
+		segment->total_audio = total;
+		for(i = 0; i < total && !progress->error; i++)
+			read_audio(progress, &segment->audio[i]);
+	}
+
+	total = get_int32(progress);
+	if((segment->video = get_array(progress, total, sizeof(mpeg3_tocvideo_t))))
+	{
+		segment->total_video = total;
+		for(i = 0; i < total && !progress->error; i++)
+			read_video(progress, &segment->video[i]);
+	}
+
+	total = get_int32(progress);
+	if((segment->subtitles = get_array(progress, total, sizeof(mpeg3_tocsubtitle_t))))
+	{
+		segment->total_subtitles = total;
+		for(i = 0; i < total && !progress->error; i++)
+			read_subtitle(progress, &segment->subtitles[i]);
+	}
+
+	if(get_int32(progress) != MPEG3_TOC_PROGRESS_PREFIX)
+		progress->error = 1;
+
+	if(progress->error)
+	{
+		clear_segment(segment);
+		return 1;
+	}
+
+	segment->done = 1;
+	return 0;
+}
+
+// Load the finished segments from the progress file.
+// Returns the bytes of the progress file to keep.
+static int64_t load_progress(mpeg3_tocscan_t *scan)
+{
+	FILE *fd = fopen(scan->progress_path, "r");
+	progress_t progress;
+	int64_t result = 0;
+
+	if(!fd) return 0;
+
+	memset(&progress, 0, sizeof(progress_t));
+	fseeko(fd, 0, SEEK_END);
+	progress.size = ftello(fd);
+	fseeko(fd, 0, SEEK_SET);
+	progress.buffer = malloc(MAX(progress.size, 1));
+	if((int64_t)fread(progress.buffer, 1, progress.size, fd) != progress.size)
+		progress.error = 1;
+	fclose(fd);
+
+// Only continue a scan of the same source
+	if(get_int32(&progress) == MPEG3_TOC_PROGRESS_PREFIX &&
+		get_int32(&progress) == MPEG3_TOC_VERSION &&
+		(int64_t)get_int64(&progress) == scan->source_date &&
+		(int64_t)get_int64(&progress) == scan->total_bytes &&
+		(int64_t)get_int64(&progress) == MPEG3_TOC_SEGMENT &&
+		!progress.error)
+	{
+		result = progress.position;
+		while(progress.position < progress.size)
+		{
+			if(read_segment(scan, &progress)) break;
+			result = progress.position;
+		}
+	}
+
+	free(progress.buffer);
+	return result;
+}
+
+static void scan_segment(mpeg3_tocscan_t *scan, mpeg3_tocsegment_t *segment)
+{
+	mpeg3_t *file = mpeg3_open_toc_source(scan->path);
+	int64_t bytes_processed = segment->start_byte;
+	int64_t end_byte = segment->end_byte;
+
+// Resynchronize the next segment
+	if(end_byte < scan->total_bytes)
+		end_byte = MIN(end_byte + MPEG3_TOC_OVERLAP, scan->total_bytes);
+
+	if(file)
+	{
+		file->toc_segment = 1;
+		file->index_bytes = scan->index_bytes;
+		mpeg3demux_seek_byte(file->demuxer, segment->start_byte);
+
+		while(!scan->interrupted && bytes_processed < end_byte)
+		{
+			mpeg3_do_toc(file, &bytes_processed);
+			segment->bytes_processed = bytes_processed - segment->start_byte;
+		}
+
+		if(scan->interrupted)
+		{
+			mpeg3_delete(file);
+			return;
+		}
+
+		mpeg3_flush_toc(file);
+		take_tracks(segment, file);
+		mpeg3_delete(file);
+	}
+	else
+	{
+		printf("scan_segment: can't open \"%s\".\n", scan->path);
+/* Leave it busy so no thread retries it and unfinished so nothing is merged */
+		pthread_mutex_lock(&scan->lock);
+		scan->error = 1;
+		pthread_mutex_unlock(&scan->lock);
+		return;
+	}
+
+	pthread_mutex_lock(&scan->lock);
+	write_segment(scan, segment);
+	segment->done = 1;
+	pthread_mutex_unlock(&scan->lock);
+//printf("scan_segment %d done\n", (int)(segment - scan->segments));
+}
+
+static void scan_loop(mpeg3_tocscan_t *scan)
+{
+	while(!scan->interrupted && !scan->error)
+	{
+		mpeg3_tocsegment_t *segment = 0;
+		int i;
+
+		pthread_mutex_lock(&scan->lock);
+		for(i = 0; i < scan->total_segments && !segment; i++)
+		{
+			if(!scan->segments[i].busy && !scan->segments[i].done)
+			{
+				segment = &scan->segments[i];
+				segment->busy = 1;
+			}
+		}
+		pthread_mutex_unlock(&scan->lock);
+
+		if(!segment) break;
+		scan_segment(scan, segment);
+	}
+}
+
+static void stop_threads(mpeg3_tocscan_t *scan)
+{
+	int i;
+	scan->interrupted = 1;
+	for(i = 0; i < scan->total_threads; i++)
+		pthread_join(scan->threads[i], 0);
+	if(scan->threads) free(scan->threads);
+	scan->threads = 0;
+	scan->total_threads = 0;
+}
+
+mpeg3_tocscan_t* mpeg3_new_tocscan(mpeg3_t *file, char *toc_path, int64_t total_bytes)
+{
+	mpeg3_tocscan_t *scan = calloc(1, sizeof(mpeg3_tocscan_t));
+	int64_t progress_bytes;
+	int i;
+
+	strncpy(scan->path, file->fs->path, MPEG3_STRLEN - 1);
+	snprintf(scan->progress_path, MPEG3_STRLEN, "%s.part", toc_path);
+	scan->source_date = file->source_date;
+	scan->total_bytes = total_bytes;
+	pthread_mutex_init(&scan->lock, 0);
+
+// The last segment takes the remainder
+	scan->total_segments = total_bytes / MPEG3_TOC_SEGMENT;
+	scan->segments = calloc(scan->total_segments, sizeof(mpeg3_tocsegment_t));
+	for(i = 0; i < scan->total_segments; i++)
+	{
+		mpeg3_tocsegment_t *segment = &scan->segments[i];
+		segment->start_byte = (int64_t)i * MPEG3_TOC_SEGMENT;
+		if(i < scan->total_segments - 1)
+			segment->end_byte = segment->start_byte + MPEG3_TOC_SEGMENT;
+		else
+			segment->end_byte = total_bytes;
+	}
+
+	progress_bytes = load_progress(scan);
+
+// Drop a segment which was being written when the scan was interrupted
+	if(progress_bytes && truncate(scan->progress_path, progress_bytes))
+	{
+		for(i = 0; i < scan->total_segments; i++)
+			clear_segment(&scan->segments[i]);
+		progress_bytes = 0;
+	}
+
+	scan->progress_fd = fopen(scan->progress_path, progress_bytes ? "a" : "w");
+	if(!scan->progress_fd)
+	{
+		printf("mpeg3_new_tocscan: can't open \"%s\".  %s\n",
+			scan->progress_path,
+			strerror(errno));
+		mpeg3_delete_tocscan(scan);
+		return 0;
+	}
+
+	if(!progress_bytes) write_header(scan);
+	return scan;
+}
+
+void mpeg3_delete_tocscan(mpeg3_tocscan_t *scan)
+{
+	int i;
+	stop_threads(scan);
+	if(scan->progress_fd) fclose(scan->progress_fd);
+	for(i = 0; i < scan->total_segments; i++)
+		clear_segment(&scan->segments[i]);
+	free(scan->segments);
+	pthread_mutex_destroy(&scan->lock);
+	free(scan);
+}
+
+int mpeg3_do_tocscan(mpeg3_t *file, int64_t *bytes_processed)
+{
+	mpeg3_tocscan_t *scan = file->toc_scan;
+	int64_t result = 0;
+	int i, done = 1;
+
+	if(!scan->threads)
+	{
+		pthread_attr_t attr;
+// Every segment gets a share of the index
+		scan->index_bytes = MAX(file->index_bytes / scan->total_segments, 0x1000);
+		scan->total_threads = MIN(MAX(file->cpus, 1), scan->total_segments);
+		scan->threads = calloc(scan->total_threads, sizeof(pthread_t));
+		pthread_attr_init(&attr);
+		for(i = 0; i < scan->total_threads; i++)
+			pthread_create(&scan->threads[i], &attr, (void*)scan_loop, scan);
+	}
+
+	usleep(100000);
+
+	if(scan->error)
+	{
+		*bytes_processed = scan->total_bytes;
+		return 1;
+	}
+
+	for(i = 0; i < scan->total_segments; i++)
+	{
+		mpeg3_tocsegment_t *segment = &scan->segments[i];
+		if(segment->done)
+			result += segment_bytes(segment);
+		else
+		{
+			done = 0;
+			result += MAX(MIN(segment->bytes_processed, segment_bytes(segment)), 0);
+		}
+	}
+
+	if(done)
+		*bytes_processed = scan->total_bytes;
+	else
+		*bytes_processed = MIN(result, scan->total_bytes - 1);
+	return 0;
+}
+
+
+
+
+
+
+
+static void merge_index(mpeg3_index_t *index,
+	mpeg3_tocaudio_t **parts,
+	int64_t *part_starts,
+	int64_t *part_deltas,
+	int total_parts,
+	int channels,
+	int64_t total_samples,
+	int64_t index_bytes)
+{
+	int zoom = 0;
+	int64_t size;
+	int i, j, k;
+
+// Bring the segments to the same zoom
+	for(i = 0; i < total_parts; i++)
+	{
+		mpeg3_index_t *part = parts[i]->index;
+		if(part->index_data && part->index_zoom > zoom)
+			zoom = part->index_zoom;
+	}
+
+	if(!zoom || !channels) return;
+
+	for(i = 0; i < total_parts; i++)
+	{
+		mpeg3_index_t *part = parts[i]->index;
+		if(part->index_data)
+		{
+			while(part->index_zoom < zoom)
+				mpeg3_divide_index(part);
+		}
+	}
+
+	size = (total_samples + zoom - 1) / zoom;
+	index->index_zoom = zoom;
+	index->index_size = size;
+	index->index_allocated = size;
+	index->index_channels = channels;
+	index->index_data = calloc(channels, sizeof(float*));
+	for(i = 0; i < channels; i++)
+		index->index_data[i] = calloc(MAX(size, 1) * 2, sizeof(float));
+
+	k = 0;
+	for(i = 0; i < size; i++)
+	{
+		int64_t sample = (int64_t)i * zoom;
+		mpeg3_index_t *part;
+		int64_t frame;
+
+		while(k < total_parts - 1 && part_starts[k + 1] <= sample) k++;
+		part = parts[k]->index;
+		frame = (sample - part_deltas[k]) / zoom;
+		if(!part->index_data || frame < 0 || frame >= part->index_size)
+			continue;
+
+		for(j = 0; j < channels && j < part->index_channels; j++)
+		{
+			index->index_data[j][i * 2] = part->index_data[j][frame * 2];
+			index->index_data[j][i * 2 + 1] = part->index_data[j][frame * 2 + 1];
+		}
+	}
+
+	while((int64_t)index->index_size * channels * (int64_t)sizeof(float) * 2 > index_bytes &&
+		!(index->index_size % 2))
+		mpeg3_divide_index(index);
+}
+
+static mpeg3_tocaudio_t* find_audio(mpeg3_tocsegment_t *segment, unsigned int pid)
+{
+	int i;
+	for(i = 0; i < segment->total_audio; i++)
+		if(segment->audio[i].pid == pid) return &segment->audio[i];
+	return 0;
+}
+
+static mpeg3_tocvideo_t* find_video(mpeg3_tocsegment_t *segment, unsigned int pid)
+{
+	int i;
+	for(i = 0; i < segment->total_video; i++)
+		if(segment->video[i].pid == pid) return &segment->video[i];
+	return 0;
+}
+
+// Sample numbers of every segment are offset to continue the samples of the
+// previous segment at the cut.  The sample offsets are created from the
+// packets the same way mpeg3_update_index creates them.
+static void merge_audio(mpeg3_t *file, mpeg3_tocscan_t *scan, unsigned int pid)
+{
+	mpeg3_atrack_t *atrack = calloc(1, sizeof(mpeg3_atrack_t));
+	mpeg3_index_t *index = mpeg3_new_index();
+	mpeg3_tocaudio_t **parts = calloc(scan->total_segments, sizeof(mpeg3_tocaudio_t*));
+	int64_t *part_starts = calloc(scan->total_segments, sizeof(int64_t));
+	int64_t *part_deltas = calloc(scan->total_segments, sizeof(int64_t));
+	mpeg3_tocpacket_t *packets = 0;
+	int total_packets = 0;
+	int packets_allocated = 0;
+	int total_parts = 0;
+	int64_t samples = 0;
+	int64_t total_samples = 0;
+	int64_t first_offset = -1;
+	int64_t last_offset = 0;
+	int64_t chunks = 0;
+	int64_t remaining;
+	int i, j;
+
+	atrack->pid = pid;
+	for(i = 0; i < scan->total_segments; i++)
+	{
+		mpeg3_tocaudio_t *audio = find_audio(&scan->segments[i], pid);
+		int64_t start, end, lead = 0, delta;
+		if(!audio) continue;
+
+// The packets before the cut are in the previous segment
+		start = total_packets ? cut_offset(scan, i - 1) : 0;
+		end = cut_offset(scan, i);
+		for(j = 0; j < audio->total_packets; j++)
+			if(audio->packets[j].offset < start) lead = audio->packets[j].samples;
+		delta = samples - lead;
+
+		if(first_offset < 0) first_offset = audio->first_offset;
+		parts[total_parts] = audio;
+		part_starts[total_parts] = samples;
+		part_deltas[total_parts] = delta;
+		total_parts++;
+
+		for(j = 0; j < audio->total_packets; j++)
+		{
+			mpeg3_tocpacket_t *packet = &audio->packets[j];
+			if(packet->offset >= start && packet->offset < end)
+			{
+				if(total_packets >= packets_allocated)
+				{
+					packets_allocated = MAX(total_packets * 2, 1024);
+					packets = realloc(packets,
+						sizeof(mpeg3_tocpacket_t) * packets_allocated);
+				}
+				packets[total_packets] = *packet;
+				packets[total_packets].samples += delta;
+				samples = packets[total_packets].samples;
+				total_packets++;
+			}
+		}
+
+		atrack->channels = MAX(atrack->channels, audio->channels);
+		atrack->audio_eof = MAX(atrack->audio_eof, audio->audio_eof);
+		total_samples = audio->total_samples + delta;
+		last_offset = audio->last_offset;
+	}
+	if(total_samples < samples) total_samples = samples;
+
+	mpeg3_append_samples(atrack, first_offset);
+	for(i = 0; i < total_packets; i++)
+	{
+		while(packets[i].samples - chunks * MPEG3_AUDIO_CHUNKSIZE > MPEG3_AUDIO_CHUNKSIZE)
+		{
+			mpeg3_append_samples(atrack, packets[i].prev_offset);
+			chunks++;
+		}
+	}
+
+// Final chunk and the chunks flushed by the last segment
+	mpeg3_append_samples(atrack, last_offset);
+	for(remaining = total_samples - chunks * MPEG3_AUDIO_CHUNKSIZE;
+		remaining > 0;
+		remaining -= MPEG3_AUDIO_CHUNKSIZE)
+		mpeg3_append_samples(atrack, last_offset);
+	atrack->current_position = total_samples;
+
+	merge_index(index,
+		parts,
+		part_starts,
+		part_deltas,
+		total_parts,
+		atrack->channels,
+		total_samples,
+		file->index_bytes);
+
+	file->atrack[file->total_astreams++] = atrack;
+	file->indexes = realloc(file->indexes,
+		sizeof(mpeg3_index_t*) * (file->total_indexes + 1));
+	file->indexes[file->total_indexes++] = index;
+
+	if(packets) free(packets);
+	free(parts);
+	free(part_starts);
+	free(part_deltas);
+}
+
+static void merge_video(mpeg3_t *file, mpeg3_tocscan_t *scan, unsigned int pid)
+{
+	mpeg3_vtrack_t *vtrack = calloc(1, sizeof(mpeg3_vtrack_t));
+	int i, j;
+
+	vtrack->pid = pid;
+	vtrack->frame_cache = mpeg3_new_cache();
+	for(i = 0; i < scan->total_segments; i++)
+	{
+		mpeg3_tocvideo_t *video = find_video(&scan->segments[i], pid);
+		int64_t start, end;
+		if(!video) continue;
+
+		start = vtrack->total_frame_offsets ? cut_offset(scan, i - 1) : 0;
+		end = cut_offset(scan, i);
+		for(j = 0; j < video->total_frames; j++)
+		{
+			if(video->frame_offsets[j] >= start && video->frame_offsets[j] < end)
+				mpeg3_append_frame(vtrack, video->frame_offsets[j], video->keyframes[j]);
+		}
+		vtrack->video_eof = MAX(vtrack->video_eof, video->video_eof);
+	}
+
+	file->vtrack[file->total_vstreams++] = vtrack;
+}
+
+int mpeg3_merge_tocscan(mpeg3_t *file)
+{
+	mpeg3_tocscan_t *scan = file->toc_scan;
+	int i, j, k;
+
+	for(i = 0; i < scan->total_segments; i++)
+		if(!scan->segments[i].done) return 1;
+	stop_threads(scan);
+
+	for(i = 0; i < scan->total_segments; i++)
+	{
+		mpeg3_tocsegment_t *segment = &scan->segments[i];
+
+		for(j = 0; j < segment->total_streams; j++)
+		{
+			int *stream = segment->streams + j * 3;
+			if(stream[1] < 0 || stream[1] >= MPEG3_MAX_STREAMS) continue;
+			if(stream[0] == STREAM_AUDIO)
+				file->demuxer->astream_table[stream[1]] = stream[2];
+			else
+				file->demuxer->vstream_table[stream[1]] = stream[2];
+		}
+
+		for(j = 0; j < segment->total_audio; j++)
+		{
+			unsigned int pid = segment->audio[j].pid;
+			for(k = 0; k < file->total_astreams; k++)
+				if(file->atrack[k]->pid == pid) break;
+			if(k >= file->total_astreams &&
+				file->total_astreams < MPEG3_MAX_STREAMS)
+				merge_audio(file, scan, pid);
+		}
+
+		for(j = 0; j < segment->total_video; j++)
+		{
+			unsigned int pid = segment->video[j].pid;
+			for(k = 0; k < file->total_vstreams; k++)
+				if(file->vtrack[k]->pid == pid) break;
+			if(k >= file->total_vstreams &&
+				file->total_vstreams < MPEG3_MAX_STREAMS)
+				merge_video(file, scan, pid);
+		}
+
+		for(j = 0; j < segment->total_subtitles; j++)
+		{
+			mpeg3_tocsubtitle_t *subtitle = &segment->subtitles[j];
+			mpeg3_strack_t *strack = mpeg3_create_strack(file, subtitle->id);
+			int64_t start = strack->total_offsets ? cut_offset(scan, i - 1) : 0;
+			int64_t end = cut_offset(scan, i);
+			for(k = 0; k < subtitle->total_offsets; k++)
+			{
+				if(subtitle->offsets[k] >= start && subtitle->offsets[k] < end)
+					mpeg3_append_subtitle_offset(strack, subtitle->offsets[k]);
+			}
+		}
+	}
+
+// The table of contents is written next
+	fclose(scan->progress_fd);
+	scan->progress_fd = 0;
+	remove(scan->progress_path);
+	return 0;
+}
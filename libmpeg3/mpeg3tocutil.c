@@ -494,24 +494,10 @@ if(debug) printf("mpeg3_read_toc 100\n");
 }
 
 
-mpeg3_t* mpeg3_start_toc(char *path, char *toc_path, int64_t *total_bytes)
+mpeg3_t* mpeg3_open_toc_source(char *path)
 {
-	*total_bytes = 0;
 	mpeg3_t *file = mpeg3_new(path);
 
-
-	file->toc_fd = fopen(toc_path, "w");
-	if(!file->toc_fd)
-	{
-		printf("mpeg3_start_toc: can't open \"%s\".  %s\n",
-			toc_path,
-			strerror(errno));
-		mpeg3_delete(file);
-		return 0;
-	}
-	
-	
-	file->source_date = mpeg3_calculate_source_date(path);
 	file->seekable = 0;
 
 /* Authenticate encryption before reading a single byte */
@@ -522,7 +508,6 @@ mpeg3_t* mpeg3_start_toc(char *path, char *toc_path, int64_t *total_bytes)
 	}
 
 // Determine file type
-	int toc_atracks = 0, toc_vtracks = 0;
 	if(mpeg3_get_file_type(file, 0, 0, 0))
 	{
 		mpeg3_delete(file);
@@ -552,8 +537,34 @@ mpeg3_t* mpeg3_start_toc(char *path, char *toc_path, int64_t *total_bytes)
 //	mpeg3demux_seek_byte(file->demuxer, 0x1734e4800LL);
 	mpeg3demux_seek_byte(file->demuxer, 0);
 	file->demuxer->read_all = 1;
+	return file;
+}
+
+mpeg3_t* mpeg3_start_toc(char *path, char *toc_path, int64_t *total_bytes)
+{
+	*total_bytes = 0;
+	mpeg3_t *file = mpeg3_open_toc_source(path);
+	if(!file) return 0;
+
+
+	file->toc_fd = fopen(toc_path, "w");
+	if(!file->toc_fd)
+	{
+		printf("mpeg3_start_toc: can't open \"%s\".  %s\n",
+			toc_path,
+			strerror(errno));
+		mpeg3_delete(file);
+		return 0;
+	}
+	
+	
+	file->source_date = mpeg3_calculate_source_date(path);
 	*total_bytes = mpeg3demux_movie_size(file->demuxer);
 
+// Large files are scanned in segments by several threads
+	if(*total_bytes >= MPEG3_TOC_SEGMENT * 2)
+		file->toc_scan = mpeg3_new_tocscan(file, toc_path, *total_bytes);
+
 //*total_bytes = 500000000;
 	return file;
 }
@@ -567,15 +578,9 @@ void mpeg3_set_index_bytes(mpeg3_t *file, int64_t bytes)
 
 
 
-static void divide_index(mpeg3_t *file, int track_number)
+void mpeg3_divide_index(mpeg3_index_t *index)
 {
-	if(file->total_indexes <= track_number) return;
-
-
 	int i, j;
-	mpeg3_atrack_t *atrack = file->atrack[track_number];
-	mpeg3_index_t *index = file->indexes[track_number];
-
 
 	index->index_size /= 2;
 	index->index_zoom *= 2;
@@ -597,6 +602,13 @@ static void divide_index(mpeg3_t *file, int track_number)
 
 }
 
+static void divide_index(mpeg3_t *file, int track_number)
+{
+	if(file->total_indexes <= track_number) return;
+
+	mpeg3_divide_index(file->indexes[track_number]);
+}
+
 
 
 
@@ -941,6 +953,10 @@ int mpeg3_do_toc(mpeg3_t *file, int64_t *bytes_processed)
 // Starting byte before our packet read
 	int64_t start_byte;
 
+// The segments are scanned by other threads
+	if(file->toc_scan)
+		return mpeg3_do_tocscan(file, bytes_processed);
+
 	start_byte = mpeg3demux_tell_byte(file->demuxer);
 
 //printf("mpeg3_do_toc 1\n");
@@ -998,6 +1014,7 @@ int mpeg3_do_toc(mpeg3_t *file, int64_t *bytes_processed)
  */
 // Update an audio track
 					handle_audio(file, i);
+					if(file->toc_segment) mpeg3_append_toc_packet(atrack, start_byte);
 					atrack->prev_offset = start_byte;
 					got_it = 1;
 					break;
@@ -1030,6 +1047,7 @@ int mpeg3_do_toc(mpeg3_t *file, int64_t *bytes_processed)
 // Make the first offset correspond to the start of the first packet.
 					mpeg3_append_samples(atrack, start_byte);
 					handle_audio(file, file->total_astreams - 1);
+					if(file->toc_segment) mpeg3_append_toc_packet(atrack, start_byte);
 					atrack->prev_offset = start_byte;
 				}
 			}
@@ -1094,10 +1112,10 @@ int mpeg3_do_toc(mpeg3_t *file, int64_t *bytes_processed)
 
 
 
-void mpeg3_stop_toc(mpeg3_t *file)
+void mpeg3_flush_toc(mpeg3_t *file)
 {
 // Create final chunk for audio tracks to count the last samples.
-	int i, j, k;
+	int i;
 	for(i = 0; i < file->total_astreams; i++)
 	{
 		mpeg3_atrack_t *atrack = file->atrack[i];
@@ -1107,6 +1125,23 @@ void mpeg3_stop_toc(mpeg3_t *file)
 // Flush audio indexes
 	for(i = 0; i < file->total_astreams; i++)
 		mpeg3_update_index(file, i, 1);
+}
+
+int mpeg3_stop_toc(mpeg3_t *file)
+{
+	int i, j, k;
+	if(file->toc_scan)
+	{
+// Keep the finished segments for the next attempt
+		if(mpeg3_merge_tocscan(file))
+		{
+			fclose(file->toc_fd);
+			mpeg3_delete(file);
+			return 1;
+		}
+	}
+	else
+		mpeg3_flush_toc(file);
 
 // Make all indexes the same scale
 	int max_scale = 1;
@@ -1355,6 +1390,7 @@ void mpeg3_stop_toc(mpeg3_t *file)
 
 
 	mpeg3_delete(file);
+	return 0;
 }
 
 
@@ -616,22 +616,22 @@ int mpeg3video_get_macroblocks(mpeg3video_t *video, int framenum)
 int mpeg3video_allocate_decoders(mpeg3video_t *video, int decoder_count)
 {
 	int i;
-	mpeg3_t *file = video->file;
 /* Get the slice decoders */
-	if(video->total_slice_decoders != file->cpus)
+	if(decoder_count > MPEG3_MAX_CPUS) decoder_count = MPEG3_MAX_CPUS;
+	if(video->total_slice_decoders != decoder_count)
 	{
 		for(i = 0; i < video->total_slice_decoders; i++)
 		{
 			mpeg3_delete_slice_decoder(&(video->slice_decoders[i]));
 		}
 
-		for(i = 0; i < file->cpus && i < MPEG3_MAX_CPUS; i++)
+		for(i = 0; i < decoder_count; i++)
 		{
 			mpeg3_new_slice_decoder(video, &(video->slice_decoders[i]));
 			video->slice_decoders[i].thread_number = i;
 		}
 
-		video->total_slice_decoders = file->cpus;
+		video->total_slice_decoders = decoder_count;
 	}
 	return 0;
 }
@@ -641,7 +641,6 @@ int mpeg3video_allocate_decoders(mpeg3video_t *video, int decoder_count)
 int mpeg3video_getpicture(mpeg3video_t *video, int framenum)
 {
 	int i, result = 0;
-	mpeg3_t *file = video->file;
 
 	if(video->pict_struct == FRAME_PICTURE && video->secondfield)
 	{
@@ -654,7 +653,7 @@ int mpeg3video_getpicture(mpeg3video_t *video, int framenum)
 		video->current_repeat = video->repeat_count = 0;
 	}
 
-	mpeg3video_allocate_decoders(video, file->cpus);
+	mpeg3video_allocate_decoders(video, video->cpus);
 
   	for(i = 0; i < 3; i++)
 	{
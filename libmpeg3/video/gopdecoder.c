@@ -0,0 +1,254 @@
+#include "../mpeg3private.h"
+#include "../mpeg3protos.h"
+#include "mpeg3video.h"
+#include <pthread.h>
+#include <stdlib.h>
+
+
+// Frame level threading.  B-frames need the following reference frame
+// and are displayed right after it, so they can't be decoded ahead of
+// the reader.  Instead, while a track is read sequentially, the GOPs after
+// the current one are given to GOP decoders.  Every GOP decoder has a
+// private track with its own demuxer and reference frames and stores the
+// frames in the cache of the track being read.
+
+
+static int frame_bytes(mpeg3video_t *video)
+{
+	return video->coded_picture_width * video->coded_picture_height +
+		2 * video->chrom_width * video->chrom_height;
+}
+
+// Index of the keyframe starting the GOP which contains the frame
+static int frame_to_gop(mpeg3_vtrack_t *track, int frame_number)
+{
+	int min = 0;
+	int max = track->total_keyframe_numbers - 1;
+
+	while(min < max)
+	{
+		int middle = (min + max + 1) / 2;
+		if(track->keyframe_numbers[middle] <= frame_number)
+			min = middle;
+		else
+			max = middle - 1;
+	}
+	return min;
+}
+
+// Frame after the GOP
+static int gop_end(mpeg3_vtrack_t *track, int gop)
+{
+	if(gop + 1 < track->total_keyframe_numbers)
+		return track->keyframe_numbers[gop + 1];
+	return track->total_frames;
+}
+
+static void decode_gop(mpeg3_gop_t *gop)
+{
+	mpeg3video_t *video = gop->video;
+	mpeg3_t *file = video->file;
+	mpeg3_vtrack_t *track = video->track;
+	mpeg3_vtrack_t *gop_track = gop->track;
+	mpeg3video_t *gop_video;
+	int result = 0;
+
+// Opened here so the reader doesn't wait for it
+	if(!gop_track)
+	{
+		gop_track = gop->track = mpeg3_new_vtrack(file,
+			track->pid,
+			file->demuxer,
+			gop->number);
+		if(!gop_track) return;
+
+// The frames go to the cache of the track being read
+		mpeg3_cache_set_size(gop_track->frame_cache, 0);
+		mpeg3video_set_cpus(gop_track->video, 1);
+	}
+	gop_video = gop_track->video;
+
+	gop_video->frame_seek = gop->start_frame;
+	result = mpeg3video_seek(gop_video);
+
+	while(!result &&
+		!gop->done &&
+		gop_video->framenum < gop->end_frame)
+	{
+		result = mpeg3video_read_frame_backend(gop_video, 0);
+		if(!result && gop_video->output_src[0])
+		{
+			mpeg3_cache_put_frame(track->frame_cache,
+				gop_video->framenum - 1,
+				gop_video->output_src[0],
+				gop_video->output_src[1],
+				gop_video->output_src[2],
+				gop_video->coded_picture_width * gop_video->coded_picture_height,
+				gop_video->chrom_width * gop_video->chrom_height,
+				gop_video->chrom_width * gop_video->chrom_height);
+		}
+	}
+//printf("decode_gop %d-%d %d\n", gop->start_frame, gop->end_frame, result);
+}
+
+static void gop_loop(mpeg3_gop_t *gop)
+{
+	while(!gop->done)
+	{
+		pthread_mutex_lock(&(gop->input_lock));
+		if(!gop->done) decode_gop(gop);
+		pthread_mutex_unlock(&(gop->completion_lock));
+	}
+}
+
+static void new_gop_decoder(mpeg3video_t *video, mpeg3_gop_t *gop, int number)
+{
+	pthread_attr_t  attr;
+	pthread_mutexattr_t mutex_attr;
+
+	gop->video = video;
+	gop->number = number;
+	gop->done = 0;
+	gop->busy = 0;
+	pthread_mutexattr_init(&mutex_attr);
+	pthread_mutex_init(&(gop->input_lock), &mutex_attr);
+	pthread_mutex_lock(&(gop->input_lock));
+	pthread_mutex_init(&(gop->completion_lock), &mutex_attr);
+	pthread_mutex_lock(&(gop->completion_lock));
+
+	pthread_attr_init(&attr);
+	pthread_create(&(gop->tid), &attr, (void*)gop_loop, gop);
+}
+
+static void delete_gop_decoder(mpeg3_gop_t *gop)
+{
+	mpeg3video_t *video = gop->video;
+
+// A GOP in progress stops at the next frame
+	gop->done = 1;
+	pthread_mutex_unlock(&(gop->input_lock));
+	pthread_join(gop->tid, 0);
+	pthread_mutex_destroy(&(gop->input_lock));
+	pthread_mutex_destroy(&(gop->completion_lock));
+	if(gop->track) mpeg3_delete_vtrack(video->file, gop->track);
+}
+
+void mpeg3video_delete_gops(mpeg3video_t *video)
+{
+	int i;
+	for(i = 0; i < video->total_gop_decoders; i++)
+		delete_gop_decoder(&(video->gop_decoders[i]));
+	if(video->gop_decoders) free(video->gop_decoders);
+	video->gop_decoders = 0;
+	video->total_gop_decoders = 0;
+	video->gop_frame = -1;
+	video->gop_scheduled = -1;
+}
+
+void mpeg3video_wait_gops(mpeg3video_t *video)
+{
+	int i;
+	for(i = 0; i < video->total_gop_decoders; i++)
+	{
+		mpeg3_gop_t *gop = &(video->gop_decoders[i]);
+		if(gop->busy)
+		{
+			pthread_mutex_lock(&(gop->completion_lock));
+			gop->busy = 0;
+		}
+	}
+}
+
+void mpeg3video_schedule_gops(mpeg3video_t *video, int frame_number)
+{
+	mpeg3_t *file = video->file;
+	mpeg3_vtrack_t *track = video->track;
+	int i, start, lookahead;
+
+// DVD subtitles are stored in the file by every demuxer
+	if(video->cpus < 2 ||
+		track->total_keyframe_numbers < 2 ||
+		video->byte_seek >= 0 ||
+		file->is_program_stream)
+		return;
+
+	for(i = 0; i < video->total_gop_decoders; i++)
+	{
+		mpeg3_gop_t *gop = &(video->gop_decoders[i]);
+// Collect the finished GOPs
+		if(gop->busy &&
+			!pthread_mutex_trylock(&(gop->completion_lock)))
+			gop->busy = 0;
+
+// Wait for the GOP containing the frame
+		if(gop->busy &&
+			frame_number >= gop->start_frame &&
+			frame_number < gop->end_frame)
+		{
+			pthread_mutex_lock(&(gop->completion_lock));
+			gop->busy = 0;
+		}
+	}
+
+// Only sequential reads are decoded ahead
+	if(frame_number != video->gop_frame)
+	{
+		video->gop_frame = frame_number + 1;
+		video->gop_scheduled = -1;
+		return;
+	}
+	video->gop_frame = frame_number + 1;
+
+	if(!video->total_gop_decoders)
+	{
+		int number = -1;
+		int64_t bytes;
+
+		for(i = 0; i < file->total_vstreams; i++)
+			if(file->vtrack[i] == track) number = i;
+		if(number < 0) return;
+
+		video->total_gop_decoders = MIN(video->cpus, MPEG3_MAX_CPUS);
+		video->gop_decoders = calloc(video->total_gop_decoders, sizeof(mpeg3_gop_t));
+		for(i = 0; i < video->total_gop_decoders; i++)
+			new_gop_decoder(video, &(video->gop_decoders[i]), number);
+
+// Make room for a GOP from every decoder, the GOP being read & the next one
+		bytes = (int64_t)frame_bytes(video) *
+			track->total_frames /
+			track->total_keyframe_numbers *
+			(video->total_gop_decoders + 2);
+		if(bytes > MPEG3_GOP_CACHE_BYTES) bytes = MPEG3_GOP_CACHE_BYTES;
+		if(bytes > mpeg3_cache_get_size(track->frame_cache))
+			mpeg3_cache_set_size(track->frame_cache, bytes);
+	}
+
+// Don't decode frames which would push the frames being read out of the cache
+	lookahead = mpeg3_cache_get_size(track->frame_cache) * 3 / 4 / frame_bytes(video);
+	start = gop_end(track, frame_to_gop(track, frame_number));
+	if(video->gop_scheduled > start) start = video->gop_scheduled;
+
+	i = 0;
+	while(start < track->total_frames)
+	{
+		int end = gop_end(track, frame_to_gop(track, start));
+		if(end - frame_number > lookahead) break;
+
+		if(!mpeg3_cache_has_frame(track->frame_cache, start) ||
+			!mpeg3_cache_has_frame(track->frame_cache, end - 1))
+		{
+			mpeg3_gop_t *gop;
+			while(i < video->total_gop_decoders &&
+				video->gop_decoders[i].busy) i++;
+			if(i >= video->total_gop_decoders) break;
+
+			gop = &(video->gop_decoders[i]);
+			gop->start_frame = start;
+			gop->end_frame = end;
+			gop->busy = 1;
+			pthread_mutex_unlock(&(gop->input_lock));
+		}
+
+		video->gop_scheduled = start = end;
+	}
+}
@@ -1,39 +1,154 @@
 #include "mpeg3private.h"
+#include "mpeg3protos.h"
+#include <pthread.h>
 #include <stdlib.h>
 #include <string.h>
 
 
 
 
-// This is basically qtcache.c with quicktime_ replaced by mpeg3_
+// Frames are found through a hash of the frame number and deleted in
+// least recently used order when the planes exceed max_usage.
+// Readers take references to the frames so the planes are never copied
+// out of the cache.  The GOP decoders store frames from their own threads
+// so every entry point takes the lock.
 
 
 mpeg3_cache_t* mpeg3_new_cache()
 {
 	mpeg3_cache_t *result = calloc(1, sizeof(mpeg3_cache_t));
+	result->max_usage = MPEG3_CACHE_BYTES;
+	pthread_mutex_init(&result->lock, 0);
 	return result;
 }
 
-void mpeg3_delete_cache(mpeg3_cache_t *ptr)
+static void delete_frame(mpeg3_cacheframe_t *frame)
+{
+	if(frame->y) free(frame->y);
+	if(frame->u) free(frame->u);
+	if(frame->v) free(frame->v);
+	free(frame);
+}
+
+static void release_frame(mpeg3_cacheframe_t *frame)
+{
+	if(!--frame->refcount) delete_frame(frame);
+}
+
+void mpeg3_cache_release_frame(mpeg3_cache_t *ptr, mpeg3_cacheframe_t *frame)
+{
+	pthread_mutex_lock(&ptr->lock);
+	release_frame(frame);
+	pthread_mutex_unlock(&ptr->lock);
+}
+
+static int frame_size(mpeg3_cacheframe_t *frame)
+{
+	return frame->y_size + frame->u_size + frame->v_size;
+}
+
+// Take the frame out of the cache without releasing it
+static void unlink_frame(mpeg3_cache_t *ptr, mpeg3_cacheframe_t *frame)
+{
+	mpeg3_cacheframe_t **hash = &ptr->hash[frame->frame_number & (MPEG3_CACHE_HASH - 1)];
+
+	while(*hash != frame) hash = &(*hash)->hash_next;
+	*hash = frame->hash_next;
+	frame->hash_next = 0;
+
+	if(frame->lru_prev) 
+		frame->lru_prev->lru_next = frame->lru_next;
+	else
+		ptr->newest = frame->lru_next;
+	if(frame->lru_next) 
+		frame->lru_next->lru_prev = frame->lru_prev;
+	else
+		ptr->oldest = frame->lru_prev;
+	frame->lru_prev = frame->lru_next = 0;
+
+	ptr->total--;
+	ptr->usage -= frame_size(frame);
+}
+
+static void link_frame(mpeg3_cache_t *ptr, mpeg3_cacheframe_t *frame)
 {
-	if(ptr->frames) 
+	mpeg3_cacheframe_t **hash = &ptr->hash[frame->frame_number & (MPEG3_CACHE_HASH - 1)];
+
+	frame->hash_next = *hash;
+	*hash = frame;
+
+	frame->lru_prev = 0;
+	frame->lru_next = ptr->newest;
+	if(ptr->newest) ptr->newest->lru_prev = frame;
+	ptr->newest = frame;
+	if(!ptr->oldest) ptr->oldest = frame;
+
+	ptr->total++;
+	ptr->usage += frame_size(frame);
+}
+
+static mpeg3_cacheframe_t* find_frame(mpeg3_cache_t *ptr, int64_t frame_number)
+{
+	mpeg3_cacheframe_t *frame = ptr->hash[frame_number & (MPEG3_CACHE_HASH - 1)];
+	while(frame && frame->frame_number != frame_number)
+		frame = frame->hash_next;
+	return frame;
+}
+
+// Delete the oldest frames until size more bytes fit.
+// Returns the last unreferenced frame deleted so its planes can be reused.
+static mpeg3_cacheframe_t* shrink_cache(mpeg3_cache_t *ptr, int64_t size)
+{
+	mpeg3_cacheframe_t *spare = 0;
+
+	while(ptr->oldest && ptr->usage + size > ptr->max_usage)
 	{
-		int i;
-		for(i = 0; i < ptr->allocation; i++)
+		mpeg3_cacheframe_t *frame = ptr->oldest;
+		unlink_frame(ptr, frame);
+
+		if(frame->refcount == 1)
 		{
-			mpeg3_cacheframe_t *frame = &ptr->frames[i];
-			if(frame->y) free(frame->y);
-			if(frame->u) free(frame->u);
-			if(frame->v) free(frame->v);
+			if(spare) release_frame(spare);
+			spare = frame;
 		}
-		free(ptr->frames);
-		free(ptr);
+		else
+			release_frame(frame);
 	}
+	return spare;
+}
+
+void mpeg3_delete_cache(mpeg3_cache_t *ptr)
+{
+	mpeg3_reset_cache(ptr);
+	pthread_mutex_destroy(&ptr->lock);
+	free(ptr);
 }
 
 void mpeg3_reset_cache(mpeg3_cache_t *ptr)
 {
-	ptr->total = 0;
+	pthread_mutex_lock(&ptr->lock);
+	while(ptr->oldest)
+	{
+		mpeg3_cacheframe_t *frame = ptr->oldest;
+		unlink_frame(ptr, frame);
+		release_frame(frame);
+	}
+	pthread_mutex_unlock(&ptr->lock);
+}
+
+void mpeg3_cache_set_size(mpeg3_cache_t *ptr, int64_t bytes)
+{
+	mpeg3_cacheframe_t *spare;
+	pthread_mutex_lock(&ptr->lock);
+	ptr->max_usage = bytes;
+	spare = shrink_cache(ptr, 0);
+	if(spare) release_frame(spare);
+	pthread_mutex_unlock(&ptr->lock);
+}
+
+int64_t mpeg3_cache_get_size(mpeg3_cache_t *ptr)
+{
+	return ptr->max_usage;
 }
 
 void mpeg3_cache_put_frame(mpeg3_cache_t *ptr,
@@ -45,116 +160,101 @@ void mpeg3_cache_put_frame(mpeg3_cache_t *ptr,
 	int u_size,
 	int v_size)
 {
-	mpeg3_cacheframe_t *frame = 0;
-	int i;
+	mpeg3_cacheframe_t *frame;
 
 //printf("mpeg3_put_frame 1\n");
-// Get existing frame
-	for(i = 0; i < ptr->total; i++)
+	pthread_mutex_lock(&ptr->lock);
+	frame = find_frame(ptr, frame_number);
+// Existing frame only becomes the most recently used
+	if(frame)
 	{
-		if(ptr->frames[i].frame_number == frame_number)
-		{
-			frame = &ptr->frames[i];
-			break;
-		}
+		unlink_frame(ptr, frame);
+		link_frame(ptr, frame);
+		pthread_mutex_unlock(&ptr->lock);
+		return;
 	}
 
-
-	if(!frame)
+	if(!y) y_size = 0;
+	if(!u) u_size = 0;
+	if(!v) v_size = 0;
+	if(y_size + u_size + v_size > ptr->max_usage)
 	{
-		if(ptr->total >= ptr->allocation)
-		{
-			int new_allocation = ptr->allocation * 2;
-//printf("mpeg3_put_frame 10 %d\n", new_allocation);
-			if(!new_allocation) new_allocation = 32;
-			ptr->frames = realloc(ptr->frames, 
-				sizeof(mpeg3_cacheframe_t) * new_allocation);
-			bzero(ptr->frames + ptr->total,
-				sizeof(mpeg3_cacheframe_t) * (new_allocation - ptr->allocation));
-//printf("mpeg3_put_frame 20 %d %d %d\n", new_allocation, ptr->allocation, ptr->total);
-			ptr->allocation = new_allocation;
-		}
-
-		frame = &ptr->frames[ptr->total];
-//printf("mpeg3_put_frame 30 %d %p %p %p\n", ptr->total, frame->y, frame->u, frame->v);
-		ptr->total++;
-
-// Memcpy is a lot slower than just dropping the seeking frames.
-		if(y) 
-		{
-			frame->y = realloc(frame->y, y_size);
-			frame->y_size = y_size;
-			memcpy(frame->y, y, y_size);
-		}
+		pthread_mutex_unlock(&ptr->lock);
+		return;
+	}
 
-		if(u)
-		{
-			frame->u = realloc(frame->u, u_size);
-			frame->u_size = u_size;
-			memcpy(frame->u, u, u_size);
-		}
+// Reuse the planes of a deleted frame instead of allocating new ones
+	frame = shrink_cache(ptr, y_size + u_size + v_size);
+	if(!frame) 
+	{
+		frame = calloc(1, sizeof(mpeg3_cacheframe_t));
+		frame->refcount = 1;
+	}
 
-		if(v)
-		{
-			frame->v = realloc(frame->v, v_size);
-			frame->v_size = v_size;
-			memcpy(frame->v, v, v_size);
-		}
-		frame->frame_number = frame_number;
+// The decoder reuses its reference frames so the planes must be copied.
+	if(frame->y_size != y_size)
+	{
+		frame->y = realloc(frame->y, y_size);
+		frame->y_size = y_size;
 	}
+	if(frame->u_size != u_size)
+	{
+		frame->u = realloc(frame->u, u_size);
+		frame->u_size = u_size;
+	}
+	if(frame->v_size != v_size)
+	{
+		frame->v = realloc(frame->v, v_size);
+		frame->v_size = v_size;
+	}
+	if(y) memcpy(frame->y, y, y_size);
+	if(u) memcpy(frame->u, u, u_size);
+	if(v) memcpy(frame->v, v, v_size);
+	frame->frame_number = frame_number;
+
+	link_frame(ptr, frame);
+	pthread_mutex_unlock(&ptr->lock);
 //printf("mpeg3_put_frame 100\n");
 }
 
-int mpeg3_cache_get_frame(mpeg3_cache_t *ptr,
-	int64_t frame_number,
-	unsigned char **y,
-	unsigned char **u,
-	unsigned char **v)
+mpeg3_cacheframe_t* mpeg3_cache_get_frame(mpeg3_cache_t *ptr,
+	int64_t frame_number)
 {
-	int i;
+	mpeg3_cacheframe_t *frame;
 
-	for(i = 0; i < ptr->total; i++)
+	pthread_mutex_lock(&ptr->lock);
+	frame = find_frame(ptr, frame_number);
+	if(frame)
 	{
-		mpeg3_cacheframe_t *frame = &ptr->frames[i];
-		if(frame->frame_number == frame_number)
+		if(frame != ptr->newest)
 		{
-			
-			*y = frame->y;
-			*u = frame->u;
-			*v = frame->v;
-			return 1;
-			break;
+			unlink_frame(ptr, frame);
+			link_frame(ptr, frame);
 		}
+		frame->refcount++;
 	}
+	pthread_mutex_unlock(&ptr->lock);
 
-	return 0;
+	return frame;
 }
 
 
 int mpeg3_cache_has_frame(mpeg3_cache_t *ptr,
 	int64_t frame_number)
 {
-	int i;
-
-	for(i = 0; i < ptr->total; i++)
-	{
-		mpeg3_cacheframe_t *frame = &ptr->frames[i];
-		if(frame->frame_number == frame_number)
-			return 1;
-	}
-
-	return 0;
+	int result;
+	pthread_mutex_lock(&ptr->lock);
+	result = find_frame(ptr, frame_number) != 0;
+	pthread_mutex_unlock(&ptr->lock);
+	return result;
 }
 
 int64_t mpeg3_cache_usage(mpeg3_cache_t *ptr)
 {
-	int64_t result = 0;
-	int i;
-	for(i = 0; i < ptr->allocation; i++)
-	{
-		mpeg3_cacheframe_t *frame = &ptr->frames[i];
-		result += frame->y_size + frame->u_size + frame->v_size;
-	}
+	int64_t result;
+	pthread_mutex_lock(&ptr->lock);
+	result = ptr->usage;
+	pthread_mutex_unlock(&ptr->lock);
 	return result;
 }
 
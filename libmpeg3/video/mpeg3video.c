@@ -223,6 +223,9 @@ mpeg3video_t* mpeg3video_allocate_struct(mpeg3_t *file, mpeg3_vtrack_t *track)
 
 	video->byte_seek = -1;
 	video->frame_seek = -1;
+	video->gop_frame = -1;
+	video->gop_scheduled = -1;
+	video->cpus = file->cpus;
 
 	mpeg3video_init_scantables(video);
 	mpeg3video_init_output();
@@ -237,6 +240,10 @@ mpeg3video_t* mpeg3video_allocate_struct(mpeg3_t *file, mpeg3_vtrack_t *track)
 int mpeg3video_delete_struct(mpeg3video_t *video)
 {
 	int i;
+	mpeg3_vtrack_t *track = video->track;
+	mpeg3video_delete_gops(video);
+	if(video->cache_frame) 
+		mpeg3_cache_release_frame(track->frame_cache, video->cache_frame);
 	mpeg3bits_delete_stream(video->vstream);
 	pthread_mutex_destroy(&(video->test_lock));
 	pthread_mutex_destroy(&(video->slice_lock));
@@ -524,6 +531,10 @@ int mpeg3video_delete(mpeg3video_t *video)
 
 int mpeg3video_set_cpus(mpeg3video_t *video, int cpus)
 {
+/* Slice decoders are reallocated on the next picture. */
+/* GOP decoders are recreated on the next sequential read. */
+	if(video->cpus != cpus) mpeg3video_delete_gops(video);
+	video->cpus = cpus;
 	return 0;
 }
 
@@ -614,13 +625,11 @@ int mpeg3video_read_frame(mpeg3video_t *video,
 
 
 // Recover from cache
-	unsigned char *y, *u, *v;
 	int frame_number = video->frame_seek >= 0 ? video->frame_seek : video->framenum;
-	if(mpeg3_cache_get_frame(track->frame_cache, 
-		frame_number, 
-		&y, 
-		&u, 
-		&v))
+	mpeg3video_schedule_gops(video, frame_number);
+	mpeg3_cacheframe_t *cache_frame = mpeg3_cache_get_frame(track->frame_cache, 
+		frame_number);
+	if(cache_frame)
 	{
 //printf("mpeg3video_read_frame 1 %d\n", frame_number);
 // Swap output data for cache data
@@ -629,21 +638,18 @@ int mpeg3video_read_frame(mpeg3video_t *video,
 		temp[1] = video->output_src[1];
 		temp[2] = video->output_src[2];
 
-		video->output_src[0] = y;
-		video->output_src[1] = u;
-		video->output_src[2] = v;
+		video->output_src[0] = cache_frame->y;
+		video->output_src[1] = cache_frame->u;
+		video->output_src[2] = cache_frame->v;
 // Transfer with cropping
 		if(video->output_src[0]) mpeg3video_present_frame(video);
 		video->output_src[0] = temp[0];
 		video->output_src[1] = temp[1];
 		video->output_src[2] = temp[2];
+		mpeg3_cache_release_frame(track->frame_cache, cache_frame);
 
-// Advance either framenum or frame_seek
-		if(frame_number == video->framenum)
-			video->framenum = ++frame_number;
-		else
-		if(frame_number == video->frame_seek)
-			video->frame_seek = ++frame_number;
+// The bitstream is still at framenum so the next decode seeks from there
+		video->frame_seek = frame_number + 1;
 	}
 	else
 	{
@@ -693,10 +699,12 @@ int mpeg3video_read_yuvframe(mpeg3video_t *video,
 
 
 // Recover from cache if framenum exists
-	unsigned char *y, *u, *v;
 	int frame_number = video->frame_seek >= 0 ? video->frame_seek : video->framenum;
+	mpeg3video_schedule_gops(video, frame_number);
+	mpeg3_cacheframe_t *cache_frame = mpeg3_cache_get_frame(track->frame_cache, 
+		frame_number);
 	
-	if(mpeg3_cache_get_frame(track->frame_cache, frame_number, &y, &u, &v))
+	if(cache_frame)
 	{
 		int chroma_denominator;
 		int size0, size1;
@@ -717,21 +725,18 @@ int mpeg3video_read_yuvframe(mpeg3video_t *video,
 		temp[1] = video->output_src[1];
 		temp[2] = video->output_src[2];
 
-		video->output_src[0] = y;
-		video->output_src[1] = u;
-		video->output_src[2] = v;
+		video->output_src[0] = cache_frame->y;
+		video->output_src[1] = cache_frame->u;
+		video->output_src[2] = cache_frame->v;
 // Transfer with cropping
 		if(video->output_src[0]) mpeg3video_present_frame(video);
 		video->output_src[0] = temp[0];
 		video->output_src[1] = temp[1];
 		video->output_src[2] = temp[2];
+		mpeg3_cache_release_frame(track->frame_cache, cache_frame);
 
-// Advance either framenum or frame_seek
-		if(frame_number == video->framenum)
-			video->framenum = ++frame_number;
-		else
-		if(frame_number == video->frame_seek)
-			video->frame_seek = ++frame_number;
+// The bitstream is still at framenum so the next decode seeks from there
+		video->frame_seek = frame_number + 1;
 	}
 	else
 	{
@@ -760,20 +765,27 @@ int mpeg3video_read_yuvframe_ptr(mpeg3video_t *video,
 
 	*y_output = *u_output = *v_output = 0;
 
-	unsigned char *y, *u, *v;
-	int frame_number = video->frame_seek >= 0 ? video->frame_seek : video->framenum;
-	if(mpeg3_cache_get_frame(track->frame_cache, frame_number, &y, &u, &v))
+// The planes from the last call are no longer needed
+	if(video->cache_frame)
 	{
-		*y_output = (char*)y;
-		*u_output = (char*)u;
-		*v_output = (char*)v;
+		mpeg3_cache_release_frame(track->frame_cache, video->cache_frame);
+		video->cache_frame = 0;
+	}
 
-// Advance either framenum or frame_seek
-		if(frame_number == video->framenum)
-			video->framenum = ++frame_number;
-		else
-		if(frame_number == video->frame_seek)
-			video->frame_seek = ++frame_number;
+	int frame_number = video->frame_seek >= 0 ? video->frame_seek : video->framenum;
+	mpeg3video_schedule_gops(video, frame_number);
+	mpeg3_cacheframe_t *cache_frame = mpeg3_cache_get_frame(track->frame_cache, 
+		frame_number);
+	if(cache_frame)
+	{
+// Hand out the cached planes until the next call
+		video->cache_frame = cache_frame;
+		*y_output = (char*)cache_frame->y;
+		*u_output = (char*)cache_frame->u;
+		*v_output = (char*)cache_frame->v;
+
+// The bitstream is still at framenum so the next decode seeks from there
+		video->frame_seek = frame_number + 1;
 	}
 	else
 // Only decode if it's a different frame
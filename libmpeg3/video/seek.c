@@ -26,7 +26,10 @@ int mpeg3video_drop_frames(mpeg3video_t *video, long frames, int cache_it)
 		if(cache_it)
 		{
 			result = mpeg3video_read_frame_backend(video, 0);
-        	if(video->output_src[0] && drop_count--)
+			if(drop_count > 0)
+				drop_count--;
+			else
+        	if(video->output_src[0])
         	{
 				mpeg3_cache_put_frame(track->frame_cache,
 					video->framenum - 1,
@@ -227,6 +230,10 @@ int mpeg3video_seek(mpeg3video_t *video)
 		video->byte_seek = -1;
 		mpeg3demux_seek_byte(demuxer, byte);
 
+// Frame numbers aren't known after a byte seek
+		mpeg3video_wait_gops(video);
+		mpeg3_reset_cache(track->frame_cache);
+
 
 // Clear subtitles
 		mpeg3_reset_subtitles(file);
@@ -316,7 +323,9 @@ int mpeg3video_seek(mpeg3video_t *video)
 /* Subtract time difference from subtitle display time. */
 		if(track->frame_offsets)
 		{
-			mpeg3_reset_cache(track->frame_cache);
+/* Going backward, decode the frames before the target into the cache */
+/* so the following frames of reverse playback don't seek again. */
+			int prefetch = frame_number < video->framenum;
 
 			if((frame_number < video->framenum || 
 				frame_number - video->framenum > MPEG3_SEEK_THRESHOLD))
@@ -354,7 +363,9 @@ int mpeg3video_seek(mpeg3video_t *video)
 						video->repeat_count = 0;
 
 // Read up to current frame
-						mpeg3video_drop_frames(video, frame_number - video->framenum, 0);
+						mpeg3video_drop_frames(video, 
+							frame_number - video->framenum, 
+							prefetch);
 						break;
 					}
 				}
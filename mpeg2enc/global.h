@@ -478,6 +478,9 @@ EXTERN_ char *input_buffer_y;
 EXTERN_ char *input_buffer_u;
 EXTERN_ char *input_buffer_v;
 EXTERN_ int input_buffer_end;
+/* Pulls the next frame directly into the encoder if set */
+EXTERN_ int (*input_callback)(void *ptr, unsigned char *frame[], int y_bytes, int uv_bytes);
+EXTERN_ void *input_callback_ptr;
 
 
 EXTERN_ int verbose;
@@ -97,6 +97,20 @@ void mpeg2enc_init_buffers()
 	pthread_mutex_lock(&input_lock);
 	pthread_mutex_lock(&copy_lock);
 	input_buffer_end = 0;
+	input_callback = 0;
+	input_callback_ptr = 0;
+}
+
+/* The callback copies the next frame into the encoder's planes and */
+/* returns 1 at the end of the sequence. */
+void mpeg2enc_set_input_callback(int (*callback)(void *ptr, 
+		unsigned char *frame[], 
+		int y_bytes, 
+		int uv_bytes), 
+	void *ptr)
+{
+	input_callback = callback;
+	input_callback_ptr = ptr;
 }
 
 int mpeg2enc(int argc, char *argv[])
@@ -201,6 +201,16 @@ static void read_buffers(long number, unsigned char *frame[])
 
 	if(chroma_format == 1) chroma_denominator = 2;
 
+	if(input_callback)
+	{
+		if(input_callback(input_callback_ptr, 
+			frame, 
+			width * height, 
+			width / 2 * height / chroma_denominator))
+			frames_scaled = 0;
+		return;
+	}
+
 	pthread_mutex_lock(&input_lock);
 
 	if(input_buffer_end) 
@@ -89,6 +89,7 @@ public:
 // required for all realtime plugins
 	int process_realtime(VFrame *input_ptr, VFrame *output_ptr);
 	int is_realtime();
+	int is_temporal();
 	const char* plugin_title();
 	int start_realtime();
 	int stop_realtime();
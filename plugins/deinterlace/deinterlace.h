@@ -80,6 +80,7 @@ public:
 		int64_t start_position,
 		double frame_rate);
 	int is_realtime();
+	int is_temporal();
 	int hide_gui();
 	void update_gui();
 	void save_data(KeyFrame *keyframe);
@@ -77,6 +77,7 @@ public:
 // required for all realtime plugins
 	int process_buffer(VFrame *frame, int64_t start_position, double frame_rate);
 	int is_realtime();
+	int is_temporal();
 	const char* plugin_title();
 	VFrame* new_picon();
 	int show_gui();
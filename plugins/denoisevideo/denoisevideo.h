@@ -110,6 +110,7 @@ public:
 
 	int process_realtime(VFrame *input, VFrame *output);
 	int is_realtime();
+	int is_temporal();
 	const char* plugin_title();
 	VFrame* new_picon();
 	int show_gui();
@@ -92,6 +92,7 @@ public:
 		int64_t start_position,
 		double frame_rate);
 	int is_realtime();
+	int is_temporal();
 	void update_gui();
 	void save_data(KeyFrame *keyframe);
 	void read_data(KeyFrame *keyframe);
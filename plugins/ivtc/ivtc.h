@@ -61,6 +61,7 @@ public:
 // required for all realtime plugins
 	int process_realtime(VFrame *input_ptr, VFrame *output_ptr);
 	int is_realtime();
+	int is_temporal();
 	void save_data(KeyFrame *keyframe);
 	void read_data(KeyFrame *keyframe);
 	PLUGIN_CLASS_MEMBERS(IVTCConfig, IVTCThread)
@@ -29,11 +29,23 @@
 
 #include "mutex.h"
 
+// Largest power of 2 a plan can be made for
+#define FFT_MAX_BITS 24
+
+// Plans are shared by every FFT and never deleted.
+// The new array execute functions are used so plans can be used by 
+// many threads at once.  Arrays passed to them must come from fftw_malloc
+// or get_buffer to have the alignment the plans were made for.
 typedef struct fftw_plan_desc {
 	int samples;
 	fftw_plan plan_forward;
 	fftw_plan plan_backward;
-	fftw_plan_desc *next;
+// Real to complex, out of place.  Complex arrays have samples / 2 + 1 
+// entries.
+	fftw_plan plan_r2c;
+	fftw_plan plan_c2r;
+// Hanning window of samples
+	double *window;
 };
 
 class FFT
@@ -58,10 +70,29 @@ public:
 	void do_fftw_inplace(unsigned int samples,
 		int inverse,
 		fftw_complex *data);
-
-// We have to get around the thread unsafety of fftw
-	static fftw_plan_desc *fftw_plans;
+// Real transforms of several channels with the same plan.
+// The inverse is normalized and destroys the input.
+	void do_fftw_r2c(int channels,
+		double **input,
+		fftw_complex **output);
+	void do_fftw_c2r(int channels,
+		fftw_complex **input,
+		double **output);
+
+// Get the shared plan for a power of 2.  Doesn't lock once it exists.
+	static fftw_plan_desc* get_plan(unsigned int samples);
+// Aligned buffers recycled between FFTs.  put_buffer takes the same size
+// get_buffer was called with.
+	static void* get_buffer(int bytes);
+	static void put_buffer(void *ptr, int bytes);
+
+// Plans indexed by bits.
+// We have to get around the thread unsafety of fftw when creating them.
+	static fftw_plan_desc *fftw_plans[FFT_MAX_BITS + 1];
 	static Mutex plans_lock;
+// Unused buffers indexed by bits of their size
+	static void *free_buffers[32];
+	static Mutex buffers_lock;
 
 
 };
@@ -108,6 +139,8 @@ public:
 		double *buffer);
 
 // Process a window in the frequency domain, called by process_buffer()
+// Only the first window_size / 2 + 1 entries of freq_real and freq_imag 
+// are used by the inverse transform.
 	virtual int signal_process();        
 
 // Process a window in the frequency domain, called by process_buffer_oversample()
@@ -132,7 +165,10 @@ private:
 	double *output_buffer;
 
 	double *temp_real;
-	double *temp_imag;
+// Half spectrum for the real transforms
+	fftw_complex *freq_data;
+// Window size the buffers were allocated for
+	long buffer_window;
 
 // samples in input_buffer
 	long input_size;
@@ -152,10 +188,10 @@ private:
 
 // Number of samples that are already processed and waiting in output_buffer
 	int samples_ready; 
-// Hanning window precalculated
+// Hanning window shared by the plan
 	double *pre_window;
-// Triangle window precalculated
-	double *post_window;
+// Scale of the Hanning window after processing
+	double post_scale;
 protected:
 // Oversample factor
 	int oversample;
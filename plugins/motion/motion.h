@@ -65,6 +65,13 @@ class RotateScan;
 // Precision of rotation
 #define MIN_ANGLE 0.0001
 
+// Limits of the early termination threshold in 8 bit levels
+#define MIN_THRESHOLD 0
+#define MAX_THRESHOLD 64
+
+// Maximum levels of the translation pyramid search
+#define MOTION_LEVELS 5
+
 #define MOTION_FILE "/tmp/motion"
 #define ROTATION_FILE "/tmp/rotate"
 
@@ -112,6 +119,10 @@ public:
 	int mode2;
 // Track a single frame, previous frame, or previous frame same block
 	int mode3;
+// Log search or pyramid search for translation
+	int search_mode;
+// Accept a translation whose mean difference is below this
+	int search_threshold;
 	enum
 	{
 // mode1
@@ -128,7 +139,10 @@ public:
 // mode3
 		TRACK_SINGLE,
 		TRACK_PREVIOUS,
-		PREVIOUS_SAME_BLOCK
+		PREVIOUS_SAME_BLOCK,
+// search_mode
+		SEARCH_LOG,
+		SEARCH_PYRAMID
 	};
 // Number of single frame to track relative to timeline start
 	int64_t track_frame;
@@ -153,6 +167,7 @@ public:
 	void draw_vectors(VFrame *frame);
 	int is_multichannel();
 	int is_realtime();
+	int is_temporal();
 	int load_defaults();
 	int save_defaults();
 	void save_data(KeyFrame *keyframe);
@@ -164,12 +179,14 @@ public:
 
 	PLUGIN_CLASS_MEMBERS(MotionConfig, MotionThread)
 
+// Stops once the difference exceeds max_difference if it's not -1
 	int64_t abs_diff(unsigned char *prev_ptr,
 		unsigned char *current_ptr,
 		int row_bytes,
 		int w,
 		int h,
-		int color_model);
+		int color_model,
+		int64_t max_difference = -1);
 	int64_t abs_diff_sub(unsigned char *prev_ptr,
 		unsigned char *current_ptr,
 		int row_bytes,
@@ -295,6 +312,8 @@ public:
 	int64_t min_pixel;
 	int is_border;
 	int valid;
+// Least difference of a pyramid search
+	int result_x, result_y;
 // For single block
 	int pixel;
 	int64_t difference1;
@@ -347,6 +366,19 @@ public:
 		VFrame *current_frame);
 	int64_t get_cache(int x, int y);
 	void put_cache(int x, int y, int64_t difference);
+// Search from the coarsest level of the pyramid to full size.
+// Returns the least difference position in pixels.
+	void pyramid_search(int *x_result, int *y_result);
+// Exhaustive search of 1 pyramid level around the previous level's result
+	void search_level(int level,
+		int search_x1,
+		int search_y1,
+		int search_x2,
+		int search_y2,
+		int *x_result,
+		int *y_result);
+	int64_t get_threshold(int w, int h);
+	void update_best(int64_t difference);
 
 // Change between previous frame and current frame multiplied by 
 // OVERSAMPLE
@@ -372,6 +404,20 @@ private:
 	int total_steps;
 	int subpixel;
 
+// Downsampled frames for the pyramid search.  Level 0 is the frame itself.
+	VFrame *previous_levels[MOTION_LEVELS];
+	VFrame *current_levels[MOTION_LEVELS];
+// Level being searched or -1 for the log search
+	int level;
+// Block in the level being searched
+	int level_x1, level_y1, level_x2, level_y2;
+// Positions in the level being searched
+	int level_scan_x1, level_scan_y1, level_scan_x2, level_scan_y2;
+// Least difference found by any package, for early termination
+	int64_t best_difference;
+// Difference below which the search stops
+	int64_t threshold;
+	int threshold_reached;
 
 	ArrayList<MotionScanCache*> cache;
 	Mutex *cache_lock;
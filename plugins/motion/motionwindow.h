@@ -74,6 +74,29 @@ public:
 	MotionWindow *gui;
 };
 
+class SearchMode : public BC_PopupMenu
+{
+public:
+	SearchMode(MotionMain *plugin, MotionWindow *gui, int x, int y);
+	int handle_event();
+	void create_objects();
+	static int calculate_w(MotionWindow *gui);
+	static int from_text(char *text);
+	static char* to_text(int mode);
+	MotionMain *plugin;
+	MotionWindow *gui;
+};
+
+class SearchThreshold : public BC_IPot
+{
+public:
+	SearchThreshold(MotionMain *plugin, 
+		int x, 
+		int y);
+	int handle_event();
+	MotionMain *plugin;
+};
+
 
 class TrackSingleFrame : public BC_Radial
 {
@@ -339,6 +362,8 @@ public:
 	MasterLayer *master_layer;
 	Mode2 *mode2;
 	Mode3 *mode3;
+	SearchMode *search_mode;
+	SearchThreshold *search_threshold;
 
 	MotionMain *plugin;
 };
@@ -60,6 +60,7 @@ public:
 		int64_t start_position,
 		double frame_rate);
 	int is_realtime();
+	int is_temporal();
 	const char* plugin_title();
 	VFrame* new_picon();
 	int show_gui();
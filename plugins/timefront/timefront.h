@@ -246,6 +246,7 @@ public:
 		double frame_rate);
 
 	int is_realtime();
+	int is_temporal();
 	int is_multichannel();
 	int load_defaults();
 	int save_defaults();
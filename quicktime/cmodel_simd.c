@@ -0,0 +1,773 @@
+/*
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+ * USA
+ */
+
+
+
+// Vectorized unscaled transfers for the most common pairs.
+// The table lookups of the scalar permutations are kept so the output is
+// identical to them.  Anything not handled here returns 0 and goes through
+// the permutations.
+
+#include "cmodel_permutation.h"
+#include <string.h>
+
+static int simd_detected = -1;
+static int simd_level = -1;
+
+static void detect_simd()
+{
+	simd_detected = CMODEL_SIMD_NONE;
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("sse2")) simd_detected = CMODEL_SIMD_SSE2;
+	if(__builtin_cpu_supports("avx2")) simd_detected = CMODEL_SIMD_AVX2;
+#endif
+	simd_level = simd_detected;
+}
+
+int cmodel_simd_level()
+{
+	if(simd_detected < 0) detect_simd();
+	return simd_level;
+}
+
+void cmodel_set_simd_level(int level)
+{
+	if(simd_detected < 0) detect_simd();
+	if(level > simd_detected) level = simd_detected;
+	if(level < CMODEL_SIMD_NONE) level = CMODEL_SIMD_NONE;
+	simd_level = level;
+}
+
+
+
+
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+// Scalar pixels for the ends of rows
+
+static inline void yuv_pixel(unsigned char *output,
+	int out_colormodel,
+	int y_in,
+	int u,
+	int v)
+{
+	int y = (y_in << 16) | (y_in << 8) | y_in;
+	int r, g, b;
+	YUV_TO_RGB(y, u, v, r, g, b)
+
+	switch(out_colormodel)
+	{
+		case BC_RGB888:
+			output[0] = r;
+			output[1] = g;
+			output[2] = b;
+			break;
+		case BC_RGBA8888:
+			output[0] = r;
+			output[1] = g;
+			output[2] = b;
+			output[3] = 0xff;
+			break;
+		case BC_BGR8888:
+			output[0] = b;
+			output[1] = g;
+			output[2] = r;
+			break;
+	}
+}
+
+static inline void rgb_to_yuv_pixel(unsigned char *output_y,
+	unsigned char *output_u,
+	unsigned char *output_v,
+	unsigned char *input,
+	int in_colormodel,
+	int column)
+{
+	int y, u, v, r, g, b;
+	if(in_colormodel == BC_RGBA8888)
+	{
+		int a = input[3];
+		r = (input[0] * a) / 0xff;
+		g = (input[1] * a) / 0xff;
+		b = (input[2] * a) / 0xff;
+	}
+	else
+	{
+		r = input[0];
+		g = input[1];
+		b = input[2];
+	}
+
+	RGB_TO_YUV(y, u, v, r, g, b);
+	output_y[column] = y;
+	output_u[column / 2] = u;
+	output_v[column / 2] = v;
+}
+
+
+
+
+#define SSE2_FN static inline __attribute__((target("sse2"), always_inline))
+#define SSE2_ROW static __attribute__((target("sse2")))
+#define AVX2_FN static inline __attribute__((target("avx2"), always_inline))
+#define AVX2_ROW static __attribute__((target("avx2")))
+
+// Converts one row of YUV to RGB
+typedef void (*yuv_row_t)(unsigned char *output,
+	unsigned char *input_y,
+	unsigned char *input_u,
+	unsigned char *input_v,
+	int w,
+	int out_colormodel);
+
+
+// ******************************** SSE2 ***************************************
+
+// Convert 8 luma values in 16 bit lanes and the 4 chroma samples they share.
+SSE2_FN void sse2_yuv8(__m128i y16,
+	unsigned char *input_u,
+	unsigned char *input_v,
+	int chroma_step,
+	__m128i *r8,
+	__m128i *g8,
+	__m128i *b8)
+{
+	int cr[4], cg[4], cb[4];
+	int k;
+	for(k = 0; k < 4; k++)
+	{
+		int u = input_u[k * chroma_step];
+		int v = input_v[k * chroma_step];
+		cr[k] = yuv_table->vtor_tab[v];
+		cg[k] = yuv_table->utog_tab[u] + yuv_table->vtog_tab[v];
+		cb[k] = yuv_table->utob_tab[u];
+	}
+
+	__m128i zero = _mm_setzero_si128();
+	__m128i y_lo = _mm_unpacklo_epi16(y16, zero);
+	__m128i y_hi = _mm_unpackhi_epi16(y16, zero);
+	y_lo = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(y_lo, 16),
+		_mm_slli_epi32(y_lo, 8)),
+		y_lo);
+	y_hi = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(y_hi, 16),
+		_mm_slli_epi32(y_hi, 8)),
+		y_hi);
+
+#define SSE2_COMPONENT(table, result) \
+{ \
+	__m128i lo = _mm_srai_epi32(_mm_add_epi32(y_lo, \
+		_mm_setr_epi32(table[0], table[0], table[1], table[1])), 16); \
+	__m128i hi = _mm_srai_epi32(_mm_add_epi32(y_hi, \
+		_mm_setr_epi32(table[2], table[2], table[3], table[3])), 16); \
+	__m128i packed = _mm_packs_epi32(lo, hi); \
+	*(result) = _mm_packus_epi16(packed, packed); \
+}
+
+	SSE2_COMPONENT(cr, r8)
+	SSE2_COMPONENT(cg, g8)
+	SSE2_COMPONENT(cb, b8)
+}
+
+// Store 8 pixels from the low halves of r8, g8, b8
+SSE2_FN void sse2_store8(unsigned char *output,
+	int out_colormodel,
+	__m128i r8,
+	__m128i g8,
+	__m128i b8)
+{
+	switch(out_colormodel)
+	{
+		case BC_RGBA8888:
+		{
+			__m128i rg = _mm_unpacklo_epi8(r8, g8);
+			__m128i ba = _mm_unpacklo_epi8(b8, _mm_set1_epi8(0xff));
+			_mm_storeu_si128((__m128i*)output, _mm_unpacklo_epi16(rg, ba));
+			_mm_storeu_si128((__m128i*)(output + 16), _mm_unpackhi_epi16(rg, ba));
+			break;
+		}
+
+		case BC_BGR8888:
+		{
+// The 4th byte isn't written
+			__m128i bg = _mm_unpacklo_epi8(b8, g8);
+			__m128i rx = _mm_unpacklo_epi8(r8, _mm_setzero_si128());
+			__m128i mask = _mm_set1_epi32(0x00ffffff);
+			__m128i old0 = _mm_loadu_si128((__m128i*)output);
+			__m128i old1 = _mm_loadu_si128((__m128i*)(output + 16));
+			_mm_storeu_si128((__m128i*)output,
+				_mm_or_si128(_mm_and_si128(_mm_unpacklo_epi16(bg, rx), mask),
+					_mm_andnot_si128(mask, old0)));
+			_mm_storeu_si128((__m128i*)(output + 16),
+				_mm_or_si128(_mm_and_si128(_mm_unpackhi_epi16(bg, rx), mask),
+					_mm_andnot_si128(mask, old1)));
+			break;
+		}
+
+		case BC_RGB888:
+		{
+			__m128i rg = _mm_unpacklo_epi8(r8, g8);
+			__m128i bx = _mm_unpacklo_epi8(b8, _mm_setzero_si128());
+			unsigned char temp[32];
+			int k;
+			_mm_storeu_si128((__m128i*)temp, _mm_unpacklo_epi16(rg, bx));
+			_mm_storeu_si128((__m128i*)(temp + 16), _mm_unpackhi_epi16(rg, bx));
+			for(k = 0; k < 8; k++)
+			{
+				output[k * 3] = temp[k * 4];
+				output[k * 3 + 1] = temp[k * 4 + 1];
+				output[k * 3 + 2] = temp[k * 4 + 2];
+			}
+			break;
+		}
+	}
+}
+
+SSE2_ROW void sse2_planar_row(unsigned char *output,
+	unsigned char *input_y,
+	unsigned char *input_u,
+	unsigned char *input_v,
+	int w,
+	int out_colormodel)
+{
+	int out_pixelsize = cmodel_calculate_pixelsize(out_colormodel);
+	int j;
+	__m128i zero = _mm_setzero_si128();
+	__m128i r8, g8, b8;
+
+	for(j = 0; j + 8 <= w; j += 8)
+	{
+		__m128i y16 = _mm_unpacklo_epi8(_mm_loadl_epi64((__m128i*)(input_y + j)),
+			zero);
+		sse2_yuv8(y16, input_u + j / 2, input_v + j / 2, 1, &r8, &g8, &b8);
+		sse2_store8(output + j * out_pixelsize, out_colormodel, r8, g8, b8);
+	}
+
+	for( ; j < w; j++)
+		yuv_pixel(output + j * out_pixelsize,
+			out_colormodel,
+			input_y[j],
+			input_u[j / 2],
+			input_v[j / 2]);
+}
+
+// YUV422 is Y U Y V so input_u and input_v are ignored.
+SSE2_ROW void sse2_yuv422_row(unsigned char *output,
+	unsigned char *input,
+	unsigned char *input_u,
+	unsigned char *input_v,
+	int w,
+	int out_colormodel)
+{
+	int out_pixelsize = cmodel_calculate_pixelsize(out_colormodel);
+	int j;
+	__m128i luma_mask = _mm_set1_epi16(0xff);
+	__m128i r8, g8, b8;
+
+	for(j = 0; j + 8 <= w; j += 8)
+	{
+		__m128i y16 = _mm_and_si128(_mm_loadu_si128((__m128i*)(input + j * 2)),
+			luma_mask);
+		sse2_yuv8(y16, input + j * 2 + 1, input + j * 2 + 3, 4, &r8, &g8, &b8);
+		sse2_store8(output + j * out_pixelsize, out_colormodel, r8, g8, b8);
+	}
+
+	for( ; j < w; j++)
+	{
+		unsigned char *pair = input + ((j * 2) & 0xfffffffc);
+		yuv_pixel(output + j * out_pixelsize,
+			out_colormodel,
+			(j & 1) ? pair[2] : pair[0],
+			pair[1],
+			pair[3]);
+	}
+}
+
+// (x * a) / 0xff for x * a in 16 bit lanes
+SSE2_FN __m128i sse2_div255(__m128i x)
+{
+	return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x, _mm_set1_epi16(1)),
+			_mm_srli_epi16(x, 8)),
+		8);
+}
+
+// RGBA8888 to BGR8888 with a black background
+SSE2_ROW void sse2_rgba_bgrx_row(unsigned char *output,
+	unsigned char *input,
+	int w)
+{
+	__m128i zero = _mm_setzero_si128();
+	__m128i mask = _mm_set1_epi32(0x00ffffff);
+	int j;
+
+	for(j = 0; j + 4 <= w; j += 4)
+	{
+		__m128i pixels = _mm_loadu_si128((__m128i*)(input + j * 4));
+		__m128i lo = _mm_unpacklo_epi8(pixels, zero);
+		__m128i hi = _mm_unpackhi_epi8(pixels, zero);
+		__m128i alpha_lo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, 0xff), 0xff);
+		__m128i alpha_hi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, 0xff), 0xff);
+		lo = sse2_div255(_mm_mullo_epi16(lo, alpha_lo));
+		hi = sse2_div255(_mm_mullo_epi16(hi, alpha_hi));
+// Swap R and B
+		lo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, _MM_SHUFFLE(3, 0, 1, 2)),
+			_MM_SHUFFLE(3, 0, 1, 2));
+		hi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, _MM_SHUFFLE(3, 0, 1, 2)),
+			_MM_SHUFFLE(3, 0, 1, 2));
+		__m128i old = _mm_loadu_si128((__m128i*)(output + j * 4));
+		_mm_storeu_si128((__m128i*)(output + j * 4),
+			_mm_or_si128(_mm_and_si128(_mm_packus_epi16(lo, hi), mask),
+				_mm_andnot_si128(mask, old)));
+	}
+
+	for( ; j < w; j++)
+	{
+		unsigned char *in = input + j * 4;
+		unsigned char *out = output + j * 4;
+		unsigned int a = in[3];
+		out[0] = ((unsigned int)in[2] * a) / 0xff;
+		out[1] = ((unsigned int)in[1] * a) / 0xff;
+		out[2] = ((unsigned int)in[0] * a) / 0xff;
+	}
+}
+
+
+
+// ******************************** AVX2 ***************************************
+
+// Convert 16 luma values in 2 vectors of 32 bit lanes and the 8 chroma
+// samples they share.  Results are 16 bytes in order.
+AVX2_FN void avx2_yuv16(__m256i y_lo,
+	__m256i y_hi,
+	__m256i u,
+	__m256i v,
+	__m128i *r8,
+	__m128i *g8,
+	__m128i *b8)
+{
+	__m256i cr = _mm256_i32gather_epi32(yuv_table->vtor_tab, v, 4);
+	__m256i cg = _mm256_add_epi32(_mm256_i32gather_epi32(yuv_table->utog_tab, u, 4),
+		_mm256_i32gather_epi32(yuv_table->vtog_tab, v, 4));
+	__m256i cb = _mm256_i32gather_epi32(yuv_table->utob_tab, u, 4);
+	__m256i dup_lo = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+	__m256i dup_hi = _mm256_setr_epi32(4, 4, 5, 5, 6, 6, 7, 7);
+
+	y_lo = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(y_lo, 16),
+		_mm256_slli_epi32(y_lo, 8)),
+		y_lo);
+	y_hi = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(y_hi, 16),
+		_mm256_slli_epi32(y_hi, 8)),
+		y_hi);
+
+#define AVX2_COMPONENT(table, result) \
+{ \
+	__m256i lo = _mm256_srai_epi32(_mm256_add_epi32(y_lo, \
+		_mm256_permutevar8x32_epi32(table, dup_lo)), 16); \
+	__m256i hi = _mm256_srai_epi32(_mm256_add_epi32(y_hi, \
+		_mm256_permutevar8x32_epi32(table, dup_hi)), 16); \
+	__m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(lo, hi), 0xd8); \
+	*(result) = _mm_packus_epi16(_mm256_castsi256_si128(packed), \
+		_mm256_extracti128_si256(packed, 1)); \
+}
+
+	AVX2_COMPONENT(cr, r8)
+	AVX2_COMPONENT(cg, g8)
+	AVX2_COMPONENT(cb, b8)
+}
+
+// Store 4 pixels of RGBX as RGB888 without touching the next pixel
+AVX2_FN void avx2_store_rgb4(unsigned char *output, __m128i pixels)
+{
+	__m128i packed = _mm_shuffle_epi8(pixels,
+		_mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1));
+	int last = _mm_cvtsi128_si32(_mm_srli_si128(packed, 8));
+	_mm_storel_epi64((__m128i*)output, packed);
+	memcpy(output + 8, &last, 4);
+}
+
+AVX2_FN void avx2_store16(unsigned char *output,
+	int out_colormodel,
+	__m128i r8,
+	__m128i g8,
+	__m128i b8)
+{
+	switch(out_colormodel)
+	{
+		case BC_RGBA8888:
+		{
+			__m128i alpha = _mm_set1_epi8(0xff);
+			__m128i rg_lo = _mm_unpacklo_epi8(r8, g8);
+			__m128i rg_hi = _mm_unpackhi_epi8(r8, g8);
+			__m128i ba_lo = _mm_unpacklo_epi8(b8, alpha);
+			__m128i ba_hi = _mm_unpackhi_epi8(b8, alpha);
+			_mm_storeu_si128((__m128i*)output, _mm_unpacklo_epi16(rg_lo, ba_lo));
+			_mm_storeu_si128((__m128i*)(output + 16), _mm_unpackhi_epi16(rg_lo, ba_lo));
+			_mm_storeu_si128((__m128i*)(output + 32), _mm_unpacklo_epi16(rg_hi, ba_hi));
+			_mm_storeu_si128((__m128i*)(output + 48), _mm_unpackhi_epi16(rg_hi, ba_hi));
+			break;
+		}
+
+		case BC_BGR8888:
+		{
+			__m128i zero = _mm_setzero_si128();
+			__m256i mask = _mm256_set1_epi32(0x00ffffff);
+			__m128i bg_lo = _mm_unpacklo_epi8(b8, g8);
+			__m128i bg_hi = _mm_unpackhi_epi8(b8, g8);
+			__m128i rx_lo = _mm_unpacklo_epi8(r8, zero);
+			__m128i rx_hi = _mm_unpackhi_epi8(r8, zero);
+			__m256i new0 = _mm256_inserti128_si256(
+				_mm256_castsi128_si256(_mm_unpacklo_epi16(bg_lo, rx_lo)),
+				_mm_unpackhi_epi16(bg_lo, rx_lo),
+				1);
+			__m256i new1 = _mm256_inserti128_si256(
+				_mm256_castsi128_si256(_mm_unpacklo_epi16(bg_hi, rx_hi)),
+				_mm_unpackhi_epi16(bg_hi, rx_hi),
+				1);
+			__m256i old0 = _mm256_loadu_si256((__m256i*)output);
+			__m256i old1 = _mm256_loadu_si256((__m256i*)(output + 32));
+			_mm256_storeu_si256((__m256i*)output,
+				_mm256_blendv_epi8(old0, new0, mask));
+			_mm256_storeu_si256((__m256i*)(output + 32),
+				_mm256_blendv_epi8(old1, new1, mask));
+			break;
+		}
+
+		case BC_RGB888:
+		{
+			__m128i zero = _mm_setzero_si128();
+			__m128i rg_lo = _mm_unpacklo_epi8(r8, g8);
+			__m128i rg_hi = _mm_unpackhi_epi8(r8, g8);
+			__m128i bx_lo = _mm_unpacklo_epi8(b8, zero);
+			__m128i bx_hi = _mm_unpackhi_epi8(b8, zero);
+			avx2_store_rgb4(output, _mm_unpacklo_epi16(rg_lo, bx_lo));
+			avx2_store_rgb4(output + 12, _mm_unpackhi_epi16(rg_lo, bx_lo));
+			avx2_store_rgb4(output + 24, _mm_unpacklo_epi16(rg_hi, bx_hi));
+			avx2_store_rgb4(output + 36, _mm_unpackhi_epi16(rg_hi, bx_hi));
+			break;
+		}
+	}
+}
+
+AVX2_ROW void avx2_planar_row(unsigned char *output,
+	unsigned char *input_y,
+	unsigned char *input_u,
+	unsigned char *input_v,
+	int w,
+	int out_colormodel)
+{
+	int out_pixelsize = cmodel_calculate_pixelsize(out_colormodel);
+	int j;
+	__m128i r8, g8, b8;
+
+	for(j = 0; j + 16 <= w; j += 16)
+	{
+		__m256i y_lo = _mm256_cvtepu8_epi32(_mm_loadl_epi64((__m128i*)(input_y + j)));
+		__m256i y_hi = _mm256_cvtepu8_epi32(_mm_loadl_epi64((__m128i*)(input_y + j + 8)));
+		__m256i u = _mm256_cvtepu8_epi32(_mm_loadl_epi64((__m128i*)(input_u + j / 2)));
+		__m256i v = _mm256_cvtepu8_epi32(_mm_loadl_epi64((__m128i*)(input_v + j / 2)));
+		avx2_yuv16(y_lo, y_hi, u, v, &r8, &g8, &b8);
+		avx2_store16(output + j * out_pixelsize, out_colormodel, r8, g8, b8);
+	}
+
+	for( ; j < w; j++)
+		yuv_pixel(output + j * out_pixelsize,
+			out_colormodel,
+			input_y[j],
+			input_u[j / 2],
+			input_v[j / 2]);
+}
+
+AVX2_ROW void avx2_yuv422_row(unsigned char *output,
+	unsigned char *input,
+	unsigned char *input_u,
+	unsigned char *input_v,
+	int w,
+	int out_colormodel)
+{
+	int out_pixelsize = cmodel_calculate_pixelsize(out_colormodel);
+	int j;
+	__m256i byte_mask = _mm256_set1_epi32(0xff);
+	__m256i luma_mask = _mm256_set1_epi16(0xff);
+	__m128i r8, g8, b8;
+
+	for(j = 0; j + 16 <= w; j += 16)
+	{
+// Each 32 bit lane is Y U Y V
+		__m256i pairs = _mm256_loadu_si256((__m256i*)(input + j * 2));
+		__m256i u = _mm256_and_si256(_mm256_srli_epi32(pairs, 8), byte_mask);
+		__m256i v = _mm256_srli_epi32(pairs, 24);
+		__m256i y16 = _mm256_and_si256(pairs, luma_mask);
+		__m256i y_lo = _mm256_cvtepu16_epi32(_mm256_castsi256_si128(y16));
+		__m256i y_hi = _mm256_cvtepu16_epi32(_mm256_extracti128_si256(y16, 1));
+		avx2_yuv16(y_lo, y_hi, u, v, &r8, &g8, &b8);
+		avx2_store16(output + j * out_pixelsize, out_colormodel, r8, g8, b8);
+	}
+
+	for( ; j < w; j++)
+	{
+		unsigned char *pair = input + ((j * 2) & 0xfffffffc);
+		yuv_pixel(output + j * out_pixelsize,
+			out_colormodel,
+			(j & 1) ? pair[2] : pair[0],
+			pair[1],
+			pair[3]);
+	}
+}
+
+// RGB888 to BGR8888
+AVX2_ROW void avx2_rgb_bgrx_row(unsigned char *output,
+	unsigned char *input,
+	int w)
+{
+	__m128i shuffle = _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1,
+		8, 7, 6, -1, 11, 10, 9, -1);
+	__m128i mask = _mm_set1_epi32(0x00ffffff);
+	int j;
+
+// Each load reads 4 bytes past the 4 pixels
+	for(j = 0; j + 6 <= w; j += 4)
+	{
+		__m128i pixels = _mm_shuffle_epi8(_mm_loadu_si128((__m128i*)(input + j * 3)),
+			shuffle);
+		__m128i old = _mm_loadu_si128((__m128i*)(output + j * 4));
+		_mm_storeu_si128((__m128i*)(output + j * 4),
+			_mm_blendv_epi8(old, pixels, mask));
+	}
+
+	for( ; j < w; j++)
+	{
+		output[j * 4] = input[j * 3 + 2];
+		output[j * 4 + 1] = input[j * 3 + 1];
+		output[j * 4 + 2] = input[j * 3];
+	}
+}
+
+// RGB888 or RGBA8888 to planar YUV.  Like the permutations, every pixel
+// writes its chroma so the odd pixel of the last row wins.
+AVX2_ROW void avx2_rgb_yuv_row(unsigned char *output_y,
+	unsigned char *output_u,
+	unsigned char *output_v,
+	unsigned char *input,
+	int w,
+	int in_colormodel)
+{
+	__m256i byte_mask = _mm256_set1_epi32(0xff);
+	__m256i odd = _mm256_setr_epi32(1, 3, 5, 7, 1, 3, 5, 7);
+	__m128i rgb_r = _mm_setr_epi8(0, -1, -1, -1, 3, -1, -1, -1,
+		6, -1, -1, -1, 9, -1, -1, -1);
+	__m128i rgb_g = _mm_setr_epi8(1, -1, -1, -1, 4, -1, -1, -1,
+		7, -1, -1, -1, 10, -1, -1, -1);
+	__m128i rgb_b = _mm_setr_epi8(2, -1, -1, -1, 5, -1, -1, -1,
+		8, -1, -1, -1, 11, -1, -1, -1);
+	int in_pixelsize = (in_colormodel == BC_RGBA8888) ? 4 : 3;
+	int j;
+
+// RGB888 loads read 4 bytes past the 8 pixels
+	for(j = 0; j + 10 <= w; j += 8)
+	{
+		__m256i r, g, b;
+		unsigned char *in = input + j * in_pixelsize;
+
+		if(in_colormodel == BC_RGBA8888)
+		{
+			__m256i pixels = _mm256_loadu_si256((__m256i*)in);
+			__m256i a = _mm256_srli_epi32(pixels, 24);
+			__m256i one = _mm256_set1_epi32(1);
+			r = _mm256_mullo_epi32(_mm256_and_si256(pixels, byte_mask), a);
+			g = _mm256_mullo_epi32(_mm256_and_si256(_mm256_srli_epi32(pixels, 8), byte_mask), a);
+			b = _mm256_mullo_epi32(_mm256_and_si256(_mm256_srli_epi32(pixels, 16), byte_mask), a);
+// x / 0xff
+			r = _mm256_srli_epi32(_mm256_add_epi32(_mm256_add_epi32(r, one),
+				_mm256_srli_epi32(r, 8)), 8);
+			g = _mm256_srli_epi32(_mm256_add_epi32(_mm256_add_epi32(g, one),
+				_mm256_srli_epi32(g, 8)), 8);
+			b = _mm256_srli_epi32(_mm256_add_epi32(_mm256_add_epi32(b, one),
+				_mm256_srli_epi32(b, 8)), 8);
+		}
+		else
+		{
+			__m128i lo = _mm_loadu_si128((__m128i*)in);
+			__m128i hi = _mm_loadu_si128((__m128i*)(in + 12));
+			r = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_shuffle_epi8(lo, rgb_r)),
+				_mm_shuffle_epi8(hi, rgb_r),
+				1);
+			g = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_shuffle_epi8(lo, rgb_g)),
+				_mm_shuffle_epi8(hi, rgb_g),
+				1);
+			b = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_shuffle_epi8(lo, rgb_b)),
+				_mm_shuffle_epi8(hi, rgb_b),
+				1);
+		}
+
+#define AVX2_RGB_TO(rtab, gtab, btab, result) \
+{ \
+	__m256i sum = _mm256_add_epi32(_mm256_add_epi32( \
+			_mm256_i32gather_epi32(yuv_table->rtab, r, 4), \
+			_mm256_i32gather_epi32(yuv_table->gtab, g, 4)), \
+		_mm256_i32gather_epi32(yuv_table->btab, b, 4)); \
+	result = _mm256_srai_epi32(sum, 16); \
+}
+		__m256i y, u, v;
+		AVX2_RGB_TO(rtoy_tab, gtoy_tab, btoy_tab, y)
+		AVX2_RGB_TO(rtou_tab, gtou_tab, btou_tab, u)
+		AVX2_RGB_TO(rtov_tab, gtov_tab, btov_tab, v)
+
+// Clamp and pack to bytes
+		__m128i y16 = _mm_packs_epi32(_mm256_castsi256_si128(y),
+			_mm256_extracti128_si256(y, 1));
+		_mm_storel_epi64((__m128i*)(output_y + j), _mm_packus_epi16(y16, y16));
+
+		u = _mm256_permutevar8x32_epi32(u, odd);
+		v = _mm256_permutevar8x32_epi32(v, odd);
+		__m128i u16 = _mm_packs_epi32(_mm256_castsi256_si128(u),
+			_mm256_castsi256_si128(u));
+		__m128i v16 = _mm_packs_epi32(_mm256_castsi256_si128(v),
+			_mm256_castsi256_si128(v));
+		int u_bytes = _mm_cvtsi128_si32(_mm_packus_epi16(u16, u16));
+		int v_bytes = _mm_cvtsi128_si32(_mm_packus_epi16(v16, v16));
+		memcpy(output_u + j / 2, &u_bytes, 4);
+		memcpy(output_v + j / 2, &v_bytes, 4);
+	}
+
+	for( ; j < w; j++)
+		rgb_to_yuv_pixel(output_y,
+			output_u,
+			output_v,
+			input + j * in_pixelsize,
+			in_colormodel,
+			j);
+}
+
+
+
+
+
+int cmodel_simd(PERMUTATION_ARGS)
+{
+	int level = cmodel_simd_level();
+	int i;
+
+	if(scale || level == CMODEL_SIMD_NONE) return 0;
+
+	switch(in_colormodel)
+	{
+		case BC_YUV420P:
+		case BC_YUV422P:
+		case BC_YUV422:
+		{
+			yuv_row_t row_function = 0;
+// YUV422 to BGR8888 doesn't replicate the luma so it stays scalar
+			if(out_colormodel == BC_RGB888 ||
+				out_colormodel == BC_RGBA8888 ||
+				(out_colormodel == BC_BGR8888 && in_colormodel != BC_YUV422))
+			{
+				if(in_colormodel == BC_YUV422)
+					row_function = (level >= CMODEL_SIMD_AVX2) ?
+						avx2_yuv422_row :
+						sse2_yuv422_row;
+				else
+					row_function = (level >= CMODEL_SIMD_AVX2) ?
+						avx2_planar_row :
+						sse2_planar_row;
+			}
+
+			if(!row_function) return 0;
+
+			for(i = 0; i < out_h; i++)
+			{
+				if(in_colormodel == BC_YUV422)
+				{
+					row_function(output_rows[i + out_y] + out_x * out_pixelsize,
+						input_rows[row_table[i]],
+						0,
+						0,
+						out_w,
+						out_colormodel);
+				}
+				else
+				{
+					int chroma_row = (in_colormodel == BC_YUV420P) ?
+						(row_table[i] / 2) :
+						row_table[i];
+					row_function(output_rows[i + out_y] + out_x * out_pixelsize,
+						in_y_plane + row_table[i] * total_in_w,
+						in_u_plane + chroma_row * (total_in_w / 2),
+						in_v_plane + chroma_row * (total_in_w / 2),
+						out_w,
+						out_colormodel);
+				}
+			}
+			return 1;
+		}
+
+		case BC_RGBA8888:
+		case BC_RGB888:
+			if(out_colormodel == BC_BGR8888)
+			{
+				if(in_colormodel == BC_RGBA8888 && bg_color <= 0)
+				{
+					for(i = 0; i < out_h; i++)
+						sse2_rgba_bgrx_row(output_rows[i + out_y] + out_x * out_pixelsize,
+							input_rows[row_table[i]],
+							out_w);
+					return 1;
+				}
+				else
+				if(in_colormodel == BC_RGB888 && level >= CMODEL_SIMD_AVX2)
+				{
+					for(i = 0; i < out_h; i++)
+						avx2_rgb_bgrx_row(output_rows[i + out_y] + out_x * out_pixelsize,
+							input_rows[row_table[i]],
+							out_w);
+					return 1;
+				}
+			}
+			else
+			if((out_colormodel == BC_YUV420P || out_colormodel == BC_YUV422P) &&
+				level >= CMODEL_SIMD_AVX2)
+			{
+				for(i = 0; i < out_h; i++)
+				{
+					int chroma_offset = (out_colormodel == BC_YUV420P) ?
+						(i / 2 * total_out_w / 2 + out_x / 2) :
+						(i * total_out_w / 2 + out_x / 2);
+					avx2_rgb_yuv_row(out_y_plane + i * total_out_w + out_x,
+						out_u_plane + chroma_offset,
+						out_v_plane + chroma_offset,
+						input_rows[row_table[i]],
+						out_w,
+						in_colormodel);
+				}
+				return 1;
+			}
+			break;
+	}
+
+	return 0;
+}
+
+#else // x86
+
+int cmodel_simd(PERMUTATION_ARGS)
+{
+	return 0;
+}
+
+#endif
@@ -0,0 +1,191 @@
+/*
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+ * USA
+ */
+
+// Time cmodel_transfer for every vector level the CPU supports and
+// compare the output with the scalar permutations.
+// Usage: cmodelbench [width] [height] [frames]
+
+#include "colormodels.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+typedef struct
+{
+	int in_colormodel;
+	int out_colormodel;
+	char *title;
+} pair_t;
+
+static pair_t pairs[] =
+{
+	{ BC_YUV420P, BC_RGB888, "YUV420P -> RGB888" },
+	{ BC_YUV420P, BC_RGBA8888, "YUV420P -> RGBA8888" },
+	{ BC_YUV420P, BC_BGR8888, "YUV420P -> BGR8888" },
+	{ BC_YUV422P, BC_RGB888, "YUV422P -> RGB888" },
+	{ BC_YUV422P, BC_BGR8888, "YUV422P -> BGR8888" },
+	{ BC_YUV422, BC_RGB888, "YUV422 -> RGB888" },
+	{ BC_YUV422, BC_RGBA8888, "YUV422 -> RGBA8888" },
+	{ BC_RGBA8888, BC_BGR8888, "RGBA8888 -> BGR8888" },
+	{ BC_RGB888, BC_BGR8888, "RGB888 -> BGR8888" },
+	{ BC_RGB888, BC_YUV420P, "RGB888 -> YUV420P" },
+	{ BC_RGBA8888, BC_YUV420P, "RGBA8888 -> YUV420P" },
+	{ BC_RGB888, BC_YUV422P, "RGB888 -> YUV422P" },
+};
+
+static char *level_to_text(int level)
+{
+	switch(level)
+	{
+		case CMODEL_SIMD_SSE2: return "sse2";
+		case CMODEL_SIMD_AVX2: return "avx2";
+	}
+	return "scalar";
+}
+
+typedef struct
+{
+	unsigned char *data;
+	unsigned char **rows;
+	unsigned char *y, *u, *v;
+	int rowspan;
+	int size;
+} frame_t;
+
+static void new_frame(frame_t *frame, int w, int h, int colormodel)
+{
+	int i;
+	frame->size = cmodel_calculate_datasize(w, h, -1, colormodel);
+// Odd sizes round the chroma planes up
+	frame->data = calloc(1, frame->size + w * 4 + h * 4);
+	frame->rows = malloc(sizeof(unsigned char*) * h);
+	frame->rowspan = cmodel_is_planar(colormodel) ?
+		w :
+		w * cmodel_calculate_pixelsize(colormodel);
+	for(i = 0; i < h; i++)
+		frame->rows[i] = frame->data + i * frame->rowspan;
+	frame->y = frame->data;
+	frame->u = frame->y + w * h;
+	frame->v = frame->u + (colormodel == BC_YUV420P ? w * h / 4 : w * h / 2);
+}
+
+static void delete_frame(frame_t *frame)
+{
+	free(frame->data);
+	free(frame->rows);
+}
+
+static void transfer(frame_t *out, frame_t *in, int w, int h, pair_t *pair)
+{
+	cmodel_transfer(out->rows,
+		in->rows,
+		out->y,
+		out->u,
+		out->v,
+		in->y,
+		in->u,
+		in->v,
+		0,
+		0,
+		w,
+		h,
+		0,
+		0,
+		w,
+		h,
+		pair->in_colormodel,
+		pair->out_colormodel,
+		0,
+		in->rowspan,
+		out->rowspan);
+}
+
+static double time_transfer(frame_t *out,
+	frame_t *in,
+	int w,
+	int h,
+	int frames,
+	pair_t *pair)
+{
+	struct timeval start, end;
+	int i;
+	gettimeofday(&start, 0);
+	for(i = 0; i < frames; i++)
+		transfer(out, in, w, h, pair);
+	gettimeofday(&end, 0);
+	return (double)(end.tv_sec - start.tv_sec) +
+		(double)(end.tv_usec - start.tv_usec) / 1000000;
+}
+
+int main(int argc, char *argv[])
+{
+	int w = 1920;
+	int h = 1080;
+	int frames = 50;
+	int max_level = cmodel_simd_level();
+	int result = 0;
+	int i, j, level;
+
+	if(argc > 1) w = atoi(argv[1]);
+	if(argc > 2) h = atoi(argv[2]);
+	if(argc > 3) frames = atoi(argv[3]);
+
+	printf("%dx%d %d frames\n", w, h, frames);
+	for(i = 0; i < sizeof(pairs) / sizeof(pair_t); i++)
+	{
+		pair_t *pair = &pairs[i];
+		frame_t in, reference, out;
+
+		new_frame(&in, w, h, pair->in_colormodel);
+		new_frame(&reference, w, h, pair->out_colormodel);
+		new_frame(&out, w, h, pair->out_colormodel);
+		srand(i);
+		for(j = 0; j < in.size; j++)
+			in.data[j] = rand();
+		memset(reference.data, 0x55, reference.size);
+
+		printf("%s\n", pair->title);
+
+		cmodel_set_simd_level(CMODEL_SIMD_NONE);
+		transfer(&reference, &in, w, h, pair);
+		for(level = CMODEL_SIMD_NONE; level <= max_level; level++)
+		{
+			double seconds;
+			cmodel_set_simd_level(level);
+			memset(out.data, 0x55, out.size);
+			transfer(&out, &in, w, h, pair);
+			seconds = time_transfer(&out, &in, w, h, frames, pair);
+			printf("    %-8s %8.1f MP/s",
+				level_to_text(level),
+				(double)w * h * frames / seconds / 1000000);
+			if(memcmp(out.data, reference.data, out.size))
+			{
+				printf(" MISMATCH");
+				result = 1;
+			}
+			printf("\n");
+		}
+
+		delete_frame(&in);
+		delete_frame(&reference);
+		delete_frame(&out);
+	}
+
+	cmodel_set_simd_level(max_level);
+	return result;
+}
@@ -414,34 +414,38 @@ void cmodel_transfer(unsigned char **output_rows,
 	bg_g, \
 	bg_b
 
-// Handle planar cmodels separately
-	switch(in_colormodel)
+// Vectorized common cases
+	if(!cmodel_simd(PERMUTATION_VALUES))
 	{
-		case BC_RGB_FLOAT:
-		case BC_RGBA_FLOAT:
-			cmodel_float(PERMUTATION_VALUES);
-			break;
-
-		case BC_YUV420P:
-		case BC_YUV422P:
-			cmodel_yuv420p(PERMUTATION_VALUES);
-			break;
-
-		case BC_YUV9P:
-			cmodel_yuv9p(PERMUTATION_VALUES);
-			break;
-
-		case BC_YUV444P:
-			cmodel_yuv444p(PERMUTATION_VALUES);
-			break;
-
-		case BC_YUV422:
-			cmodel_yuv422(PERMUTATION_VALUES);
-			break;
-
-		default:
-			cmodel_default(PERMUTATION_VALUES);
-			break;
+// Handle planar cmodels separately
+		switch(in_colormodel)
+		{
+			case BC_RGB_FLOAT:
+			case BC_RGBA_FLOAT:
+				cmodel_float(PERMUTATION_VALUES);
+				break;
+
+			case BC_YUV420P:
+			case BC_YUV422P:
+				cmodel_yuv420p(PERMUTATION_VALUES);
+				break;
+
+			case BC_YUV9P:
+				cmodel_yuv9p(PERMUTATION_VALUES);
+				break;
+
+			case BC_YUV444P:
+				cmodel_yuv444p(PERMUTATION_VALUES);
+				break;
+
+			case BC_YUV422:
+				cmodel_yuv422(PERMUTATION_VALUES);
+				break;
+
+			default:
+				cmodel_default(PERMUTATION_VALUES);
+				break;
+		}
 	}
 
 /*
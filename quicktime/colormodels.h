@@ -142,6 +142,44 @@ void cmodel_transfer(unsigned char **output_rows, /* Leave NULL if non existent
 	int in_rowspan,       /* For planar use the luma rowspan */
 	int out_rowspan);     /* For planar use the luma rowspan */
 
+// Vector units used by unscaled transfers.  Defaults to the best one the
+// CPU supports.  Setting a level higher than the CPU supports is ignored.
+#define CMODEL_SIMD_NONE 0
+#define CMODEL_SIMD_SSE2 1
+#define CMODEL_SIMD_AVX2 2
+int cmodel_simd_level();
+void cmodel_set_simd_level(int level);
+// Returns 1 if the transfer was handled by a vector unit
+int cmodel_simd(unsigned char **output_rows,
+	unsigned char **input_rows,
+	unsigned char *out_y_plane,
+	unsigned char *out_u_plane,
+	unsigned char *out_v_plane,
+	unsigned char *in_y_plane,
+	unsigned char *in_u_plane,
+	unsigned char *in_v_plane,
+	int in_x,
+	int in_y,
+	int in_w,
+	int in_h,
+	int out_x,
+	int out_y,
+	int out_w,
+	int out_h,
+	int in_colormodel,
+	int out_colormodel,
+	int bg_color,
+	int total_in_w,
+	int total_out_w,
+	int scale,
+	int out_pixelsize,
+	int in_pixelsize,
+	int *row_table,
+	int *column_table,
+	int bg_r,
+	int bg_g,
+	int bg_b);
+
 void cmodel_init_yuv(cmodel_yuv_t *yuv_table);
 void cmodel_delete_yuv(cmodel_yuv_t *yuv_table);
 int cmodel_bc_to_x(int color_model);
@@ -315,8 +315,17 @@ int quicktime_chunk_of_sample(int64_t *chunk_sample,
 
 
 
+/* Return a pointer to the next size bytes of a mapped file and advance the */
+/* position.  Returns 0 if the file isn't mapped or the range is outside it. */
+unsigned char* quicktime_read_data_ptr(quicktime_t *file, int64_t size);
+/* Direction the video is being read in for the kernel read ahead */
+void quicktime_mmap_direction(quicktime_t *file, int direction);
+
 /* converting between mdat offsets to samples */
 int64_t quicktime_sample_to_offset(quicktime_t *file, quicktime_trak_t *trak, int64_t sample);
+/* Expand the sample tables of a track being read for constant time seeking */
+void quicktime_trak_build_index(quicktime_t *file, quicktime_trak_t *trak);
+void quicktime_trak_delete_index(quicktime_trak_t *trak);
 long quicktime_offset_to_sample(quicktime_trak_t *trak, int64_t offset);
 quicktime_trak_t* quicktime_add_trak(quicktime_t *file);
 
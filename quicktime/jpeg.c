@@ -92,6 +92,7 @@ static int decode(quicktime_t *file,
 	quicktime_trak_t *trak = vtrack->track;
 	mjpeg_t *mjpeg = codec->mjpeg;
 	long size, field2_offset = 0;
+	unsigned char *buffer;
 	int track_height = trak->tkhd.track_height;
 	int track_width = trak->tkhd.track_width;
 	int result = 0;
@@ -107,13 +108,19 @@ static int decode(quicktime_t *file,
 	size = quicktime_frame_size(file, vtrack->current_position, track);
 	codec->buffer_size = size;
 
-	if(size > codec->buffer_allocated)
+/* Decompress straight from a mapped file */
+	buffer = quicktime_read_data_ptr(file, size);
+	if(!buffer)
 	{
-		codec->buffer_allocated = size;
-		codec->buffer = realloc(codec->buffer, codec->buffer_allocated);
-	}
+		if(size > codec->buffer_allocated)
+		{
+			codec->buffer_allocated = size;
+			codec->buffer = realloc(codec->buffer, codec->buffer_allocated);
+		}
 
-	result = !quicktime_read_data(file, codec->buffer, size);
+		result = !quicktime_read_data(file, codec->buffer, size);
+		buffer = codec->buffer;
+	}
 /*
  * printf("decode 1 %02x %02x %02x %02x %02x %02x %02x %02x\n", 
  * codec->buffer[0],
@@ -133,19 +140,19 @@ static int decode(quicktime_t *file,
 		{
 			if(file->use_avi)
 			{
-				field2_offset = mjpeg_get_avi_field2(codec->buffer, 
+				field2_offset = mjpeg_get_avi_field2(buffer, 
 					size, 
 					&field_dominance);
 			}
 			else
 			{
-				field2_offset = mjpeg_get_quicktime_field2(codec->buffer, 
+				field2_offset = mjpeg_get_quicktime_field2(buffer, 
 					size);
 // Sanity check
 				if(!field2_offset)
 				{
 					printf("decode: FYI field2_offset=0\n");
-					field2_offset = mjpeg_get_field2(codec->buffer, size);
+					field2_offset = mjpeg_get_field2(buffer, size);
 				}
 			}
 		}
@@ -175,7 +182,7 @@ static int decode(quicktime_t *file,
 		{
 			int i;
 			mjpeg_decompress(codec->mjpeg, 
-				codec->buffer, 
+				buffer, 
 				size,
 				field2_offset,  
 				row_pointers, 
@@ -200,7 +207,7 @@ static int decode(quicktime_t *file,
 
 //printf("decode 10\n");
 			mjpeg_decompress(codec->mjpeg, 
-				codec->buffer, 
+				buffer, 
 				size,
 				field2_offset,  
 				temp_rows, 
@@ -86,11 +86,26 @@ static int decode(quicktime_t *file, unsigned char **row_pointers, int track)
 	int i;
 	int decode_colormodel = 0;
 	int pitches[3] = { 720 * 2, 0, 0 };
+	unsigned char *data;
 
 
 	quicktime_set_video_position(file, vtrack->current_position, track);
 	bytes = quicktime_frame_size(file, vtrack->current_position, track);
-	result = !quicktime_read_data(file, (char*)codec->data, bytes);
+/* Libdv reads a full frame so only decode from a mapped file if the frame is */
+/* complete.  Bit 7 of byte 3 of the header is set for 625 line frames. */
+	data = 0;
+	if(bytes >= DV_NTSC_SIZE)
+		data = quicktime_read_data_ptr(file, bytes);
+	if(data && (data[3] & 0x80) && bytes < DV_PAL_SIZE)
+	{
+		data = 0;
+		quicktime_set_video_position(file, vtrack->current_position, track);
+	}
+	if(!data)
+	{
+		result = !quicktime_read_data(file, (char*)codec->data, bytes);
+		data = codec->data;
+	}
 
 	if( codec->dv_decoder && codec->parameters_changed )
 	{
@@ -122,7 +137,7 @@ static int decode(quicktime_t *file, unsigned char **row_pointers, int track)
 
 		codec->dv_decoder->quality = codec->decode_quality;
 
-		dv_parse_header( codec->dv_decoder, codec->data );
+		dv_parse_header( codec->dv_decoder, data );
 		
 // Libdv improperly decodes RGB colormodels.
 		if((file->color_model == BC_YUV422 || 
@@ -138,7 +153,7 @@ static int decode(quicktime_t *file, unsigned char **row_pointers, int track)
 			if( file->color_model == BC_YUV422 )
 			{
 				pitches[0] = 720 * 2;
-				dv_decode_full_frame( codec->dv_decoder, codec->data,
+				dv_decode_full_frame( codec->dv_decoder, data,
 									  e_dv_color_yuv, row_pointers,
 									  pitches );
 			}
@@ -146,7 +161,7 @@ static int decode(quicktime_t *file, unsigned char **row_pointers, int track)
 			if( file->color_model == BC_RGB888)
  			{
 				pitches[0] = 720 * 3;
-				dv_decode_full_frame( codec->dv_decoder, codec->data,
+				dv_decode_full_frame( codec->dv_decoder, data,
 									  e_dv_color_rgb, row_pointers,
 									  pitches );
 			}
@@ -163,7 +178,7 @@ static int decode(quicktime_t *file, unsigned char **row_pointers, int track)
 
 		    decode_colormodel = BC_YUV422;
 			pitches[0] = 720 * 2;
-			dv_decode_full_frame( codec->dv_decoder, codec->data,
+			dv_decode_full_frame( codec->dv_decoder, data,
 								  e_dv_color_yuv, codec->temp_rows,
 								  pitches );
 			
@@ -316,6 +316,13 @@ typedef struct
 	quicktime_stsc_t stsc;
 	quicktime_stsz_t stsz;
 	quicktime_stco_t stco;
+
+/* Flattened tables for seeking, built when a file is opened for reading. */
+/* First sample of every stsc entry */
+	int64_t *stsc_samples;
+/* File offset of every sample with its own size in stsz */
+	int64_t *sample_offsets;
+	int64_t total_sample_offsets;
 } quicktime_stbl_t;
 
 /* data reference */
@@ -732,6 +739,17 @@ typedef struct
 	int64_t preload_end;       /* End of preload buffer in file */
 	int64_t preload_ptr;       /* Offset of preload_start in preload_buffer */
 
+/* Memory mapped file.  Replaces the preload buffer when reading. */
+	unsigned char *mmap_buffer;
+	int64_t mmap_size;
+/* 1 when the video is read forward, -1 when it's read backward */
+	int mmap_direction;
+/* Range last given to madvise */
+	int64_t mmap_advise_start;
+	int64_t mmap_advise_end;
+/* Amount to read ahead of the current position when mapped */
+#define QUICKTIME_MMAP_READAHEAD 0x800000
+
 /* Write ahead buffer */
 /* Amount of data in presave buffer */
 	int64_t presave_size;
@@ -497,6 +497,11 @@ int quicktime_set_video_position(quicktime_t *file, int64_t frame, int track)
 	if(track < file->total_vtracks && track >= 0)
 	{
 		trak = file->vtracks[track].track;
+		if(frame < file->vtracks[track].current_position)
+			quicktime_mmap_direction(file, -1);
+		else
+		if(frame > file->vtracks[track].current_position)
+			quicktime_mmap_direction(file, 1);
 		file->vtracks[track].current_position = frame;
 		quicktime_chunk_of_sample(&chunk_sample, &chunk, trak, frame);
 		file->vtracks[track].current_chunk = chunk;
@@ -847,7 +852,8 @@ int64_t quicktime_get_keyframe_before(quicktime_t *file, int64_t frame, int trac
 {
 	quicktime_trak_t *trak = file->vtracks[track].track;
 	quicktime_stss_t *stss = &trak->mdia.minf.stbl.stss;
-	int i;
+	long min_entry = 0;
+	long max_entry = stss->total_entries - 1;
 
 
 
@@ -857,19 +863,26 @@ int64_t quicktime_get_keyframe_before(quicktime_t *file, int64_t frame, int trac
 	frame++;
 
 
-	for(i = stss->total_entries - 1; i >= 0; i--)
+// The stss is sorted so search for the last keyframe at or before the frame
+	if(!stss->total_entries || stss->table[0].sample > frame) return 0;
+	while(min_entry < max_entry)
 	{
-		if(stss->table[i].sample <= frame) return stss->table[i].sample - 1;
+		long entry = (min_entry + max_entry + 1) / 2;
+		if(stss->table[entry].sample <= frame)
+			min_entry = entry;
+		else
+			max_entry = entry - 1;
 	}
 
-	return 0;
+	return stss->table[min_entry].sample - 1;
 }
 
 int64_t quicktime_get_keyframe_after(quicktime_t *file, int64_t frame, int track)
 {
 	quicktime_trak_t *trak = file->vtracks[track].track;
 	quicktime_stss_t *stss = &trak->mdia.minf.stbl.stss;
-	int i;
+	long min_entry = 0;
+	long max_entry = stss->total_entries - 1;
 
 
 
@@ -879,12 +892,18 @@ int64_t quicktime_get_keyframe_after(quicktime_t *file, int64_t frame, int track
 	frame++;
 
 
-	for(i = 0; i < stss->total_entries; i++)
+// First keyframe at or after the frame
+	if(!stss->total_entries || stss->table[max_entry].sample < frame) return 0;
+	while(min_entry < max_entry)
 	{
-		if(stss->table[i].sample >= frame) return stss->table[i].sample - 1;
+		long entry = (min_entry + max_entry) / 2;
+		if(stss->table[entry].sample >= frame)
+			max_entry = entry;
+		else
+			min_entry = entry + 1;
 	}
 
-	return 0;
+	return stss->table[min_entry].sample - 1;
 }
 
 void quicktime_insert_keyframe(quicktime_t *file, int64_t frame, int track)
@@ -1172,6 +1191,12 @@ int quicktime_read_info(quicktime_t *file)
 	if(got_header)
 	{
 		quicktime_init_maps(file);
+
+		if(!file->wr)
+		{
+			for(i = 0; i < file->moov.total_tracks; i++)
+				quicktime_trak_build_index(file, file->moov.trak[i]);
+		}
 	}
 
 /* Shut down preload in case of an obsurdly high temp_size */
@@ -420,6 +420,11 @@ int quicktime_set_cpus(quicktime_t *file, int cpus);
 /* reading the header internally. */
 void quicktime_set_preload(quicktime_t *file, int64_t preload);
 
+/* Map a file opened for reading into memory so codecs can decompress */
+/* frames directly from the mapping instead of copying them out of stdio. */
+/* Returns 1 if the file couldn't be mapped.  Reads then go through stdio. */
+int quicktime_set_mmap(quicktime_t *file, int value);
+
 int64_t quicktime_byte_position(quicktime_t *file);
 
 /* Set frame offset for programme timecode */
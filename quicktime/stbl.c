@@ -11,6 +11,9 @@ void quicktime_stbl_init(quicktime_stbl_t *stbl)
 	quicktime_stsc_init(&(stbl->stsc));
 	quicktime_stsz_init(&(stbl->stsz));
 	quicktime_stco_init(&(stbl->stco));
+	stbl->stsc_samples = 0;
+	stbl->sample_offsets = 0;
+	stbl->total_sample_offsets = 0;
 }
 
 void quicktime_stbl_init_video(quicktime_t *file, 
@@ -61,6 +64,11 @@ void quicktime_stbl_delete(quicktime_stbl_t *stbl)
 	quicktime_stsc_delete(&(stbl->stsc));
 	quicktime_stsz_delete(&(stbl->stsz));
 	quicktime_stco_delete(&(stbl->stco));
+	if(stbl->stsc_samples) free(stbl->stsc_samples);
+	if(stbl->sample_offsets) free(stbl->sample_offsets);
+	stbl->stsc_samples = 0;
+	stbl->sample_offsets = 0;
+	stbl->total_sample_offsets = 0;
 }
 
 void quicktime_stbl_dump(void *minf_ptr, quicktime_stbl_t *stbl)
@@ -319,6 +319,31 @@ int quicktime_chunk_of_sample(int64_t *chunk_sample,
 	long total_entries = trak->mdia.minf.stbl.stsc.total_entries;
 	long chunk2entry;
 	long chunk1, chunk2, chunk1samples, range_samples, total = 0;
+	int64_t *stsc_samples = trak->mdia.minf.stbl.stsc_samples;
+
+	if(stsc_samples && total_entries)
+	{
+/* Last stsc entry starting at or before the sample */
+		long min_entry = 0;
+		long max_entry = total_entries - 1;
+		while(min_entry < max_entry)
+		{
+			long entry = (min_entry + max_entry + 1) / 2;
+			if(stsc_samples[entry] <= sample)
+				min_entry = entry;
+			else
+				max_entry = entry - 1;
+		}
+
+		chunk1 = table[min_entry].chunk;
+		chunk1samples = table[min_entry].samples;
+		if(chunk1samples)
+			*chunk = (sample - stsc_samples[min_entry]) / chunk1samples + chunk1;
+		else
+			*chunk = 1;
+		*chunk_sample = stsc_samples[min_entry] + (*chunk - chunk1) * chunk1samples;
+		return 0;
+	}
 
 	chunk1 = 1;
 	chunk1samples = 0;
@@ -449,6 +474,10 @@ int64_t quicktime_sample_to_offset(quicktime_t *file,
 	int64_t sample)
 {
 	int64_t chunk, chunk_sample, chunk_offset1, chunk_offset2;
+	quicktime_stbl_t *stbl = &trak->mdia.minf.stbl;
+
+	if(sample >= 0 && sample < stbl->total_sample_offsets)
+		return stbl->sample_offsets[sample];
 
 	quicktime_chunk_of_sample(&chunk_sample, &chunk, trak, sample);
 	chunk_offset1 = quicktime_chunk_to_offset(file, trak, chunk);
@@ -457,6 +486,77 @@ int64_t quicktime_sample_to_offset(quicktime_t *file,
 	return chunk_offset2;
 }
 
+void quicktime_trak_build_index(quicktime_t *file, quicktime_trak_t *trak)
+{
+	quicktime_stbl_t *stbl = &trak->mdia.minf.stbl;
+	quicktime_stsc_t *stsc = &stbl->stsc;
+	quicktime_stsz_t *stsz = &stbl->stsz;
+	quicktime_stco_t *stco = &stbl->stco;
+	int64_t total = 0;
+	long i;
+
+	quicktime_trak_delete_index(trak);
+
+	if(stsc->total_entries)
+	{
+		stbl->stsc_samples = malloc(sizeof(int64_t) * stsc->total_entries);
+		stbl->stsc_samples[0] = 0;
+		for(i = 1; i < stsc->total_entries; i++)
+		{
+			total += (stsc->table[i].chunk - stsc->table[i - 1].chunk) * 
+				stsc->table[i - 1].samples;
+			stbl->stsc_samples[i] = total;
+		}
+	}
+
+/* Audio offsets are computed from the sample size in the stsd */
+	if(!trak->mdia.minf.is_audio && 
+		!stsz->sample_size && 
+		stsz->total_entries &&
+		stsc->total_entries)
+	{
+		int64_t sample = 0;
+		long chunk;
+		long entry = 0;
+
+		stbl->sample_offsets = malloc(sizeof(int64_t) * stsz->total_entries);
+		for(chunk = 1; 
+			chunk <= stco->total_entries && sample < stsz->total_entries; 
+			chunk++)
+		{
+			int64_t offset = quicktime_chunk_to_offset(file, trak, chunk);
+			long chunk_samples;
+
+			while(entry < stsc->total_entries - 1 && 
+				stsc->table[entry + 1].chunk <= chunk)
+				entry++;
+			chunk_samples = (chunk < stsc->table[entry].chunk) ? 
+				0 : 
+				stsc->table[entry].samples;
+
+			for(i = 0; i < chunk_samples && sample < stsz->total_entries; i++)
+			{
+				stbl->sample_offsets[sample] = offset;
+				offset += stsz->table[sample].size;
+				sample++;
+			}
+		}
+
+/* Samples past the last chunk fall back to the stsc walk */
+		stbl->total_sample_offsets = sample;
+	}
+}
+
+void quicktime_trak_delete_index(quicktime_trak_t *trak)
+{
+	quicktime_stbl_t *stbl = &trak->mdia.minf.stbl;
+	if(stbl->stsc_samples) free(stbl->stsc_samples);
+	if(stbl->sample_offsets) free(stbl->sample_offsets);
+	stbl->stsc_samples = 0;
+	stbl->sample_offsets = 0;
+	stbl->total_sample_offsets = 0;
+}
+
 long quicktime_offset_to_sample(quicktime_trak_t *trak, int64_t offset)
 {
 	int64_t chunk_offset;
@@ -709,6 +809,8 @@ int quicktime_trak_shift_offsets(quicktime_trak_t *trak, int64_t offset)
 	quicktime_stco_t *stco = &(trak->mdia.minf.stbl.stco);
 	int i;
 
+	quicktime_trak_delete_index(trak);
+
 	for(i = 0; i < stco->total_entries; i++)
 	{
 		stco->table[i].offset += offset;
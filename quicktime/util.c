@@ -4,6 +4,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <time.h>
 #include <unistd.h>
@@ -61,6 +62,8 @@ int quicktime_file_open(quicktime_t *file, char *path, int rd, int wr)
 
 int quicktime_file_close(quicktime_t *file)
 {
+	quicktime_set_mmap(file, 0);
+
 /* Flush presave buffer */
 	if(file->presave_size)
 	{
@@ -96,6 +99,104 @@ int quicktime_fseek(quicktime_t *file, int64_t offset)
 	return 0;
 }
 
+int quicktime_set_mmap(quicktime_t *file, int value)
+{
+	if(value && !file->mmap_buffer)
+	{
+		void *buffer;
+
+		if(!file->stream || 
+			!file->rd || 
+			file->wr || 
+			file->total_length <= 0 ||
+			(size_t)file->total_length != file->total_length)
+			return 1;
+
+/* Private so codecs which patch their input only dirty a copy of the page */
+		buffer = mmap(0, 
+			file->total_length, 
+			PROT_READ | PROT_WRITE, 
+			MAP_PRIVATE, 
+			fileno(file->stream), 
+			0);
+		if(buffer == MAP_FAILED)
+		{
+			perror("quicktime_set_mmap mmap");
+			return 1;
+		}
+
+		file->mmap_buffer = buffer;
+		file->mmap_size = file->total_length;
+		file->mmap_direction = 1;
+		file->mmap_advise_start = 0;
+		file->mmap_advise_end = 0;
+		madvise(file->mmap_buffer, file->mmap_size, MADV_SEQUENTIAL);
+	}
+	else
+	if(!value && file->mmap_buffer)
+	{
+		munmap(file->mmap_buffer, file->mmap_size);
+		file->mmap_buffer = 0;
+		file->mmap_size = 0;
+	}
+	return 0;
+}
+
+void quicktime_mmap_direction(quicktime_t *file, int direction)
+{
+	if(!file->mmap_buffer || direction == file->mmap_direction) return;
+
+/* The kernel only reads ahead forward so do it ourselves going backward */
+	file->mmap_direction = direction;
+	madvise(file->mmap_buffer, 
+		file->mmap_size, 
+		direction > 0 ? MADV_SEQUENTIAL : MADV_RANDOM);
+	file->mmap_advise_start = 0;
+	file->mmap_advise_end = 0;
+}
+
+/* Request the pages ahead of a read in the direction of playback */
+static void advise_mmap(quicktime_t *file, int64_t start, int64_t end)
+{
+	int64_t page_size = getpagesize();
+
+	if(start >= file->mmap_advise_start && 
+		end <= file->mmap_advise_end) return;
+
+	if(file->mmap_direction > 0)
+	{
+		end = start + QUICKTIME_MMAP_READAHEAD;
+	}
+	else
+	{
+		start = end - QUICKTIME_MMAP_READAHEAD;
+	}
+
+	start = start / page_size * page_size;
+	if(start < 0) start = 0;
+	if(end > file->mmap_size) end = file->mmap_size;
+	if(end <= start) return;
+
+	madvise(file->mmap_buffer + start, end - start, MADV_WILLNEED);
+	file->mmap_advise_start = start;
+	file->mmap_advise_end = end;
+}
+
+unsigned char* quicktime_read_data_ptr(quicktime_t *file, int64_t size)
+{
+	unsigned char *result;
+
+	if(!file->mmap_buffer || 
+		file->file_position < 0 ||
+		size < 0 ||
+		file->file_position + size > file->mmap_size) return 0;
+
+	advise_mmap(file, file->file_position, file->file_position + size);
+	result = file->mmap_buffer + file->file_position;
+	file->file_position += size;
+	return result;
+}
+
 /* Read entire buffer from the preload buffer */
 static int read_preload(quicktime_t *file, char *data, int64_t size)
 {
@@ -131,6 +232,30 @@ int quicktime_read_data(quicktime_t *file, char *data, int64_t size)
 {
 	int result = 1;
 
+	if(file->mmap_buffer)
+	{
+		int64_t fragment_len = size;
+		if(file->file_position < 0 || 
+			file->file_position >= file->mmap_size)
+			fragment_len = 0;
+		else
+		if(file->file_position + fragment_len > file->mmap_size)
+			fragment_len = file->mmap_size - file->file_position;
+
+		if(fragment_len > 0)
+		{
+			advise_mmap(file, 
+				file->file_position, 
+				file->file_position + fragment_len);
+			memcpy(data, file->mmap_buffer + file->file_position, fragment_len);
+		}
+		if(fragment_len < size)
+		{
+			memset(data + fragment_len, 0, size - fragment_len);
+			result = 0;
+		}
+	}
+	else
 	if(!file->preload_size)
 	{
 		quicktime_fseek(file, file->file_position);
@@ -77,6 +77,7 @@ static int decode(quicktime_t *file, unsigned char **row_pointers, int track)
 	int width = vtrack->track->tkhd.track_width;
 	int height = vtrack->track->tkhd.track_height;
 	unsigned char **input_rows;
+	unsigned char *buffer;
 	if(!codec->work_buffer)
 		codec->work_buffer = malloc(vtrack->track->tkhd.track_width * 
 			vtrack->track->tkhd.track_height *
@@ -85,13 +86,21 @@ static int decode(quicktime_t *file, unsigned char **row_pointers, int track)
 
 	quicktime_set_video_position(file, vtrack->current_position, track);
 	bytes = quicktime_frame_size(file, vtrack->current_position, track);
-	result = !quicktime_read_data(file, codec->work_buffer, bytes);
+/* Convert straight from a mapped file if the frame is complete */
+	buffer = 0;
+	if(bytes >= width * height * 4)
+		buffer = quicktime_read_data_ptr(file, bytes);
+	if(!buffer)
+	{
+		result = !quicktime_read_data(file, codec->work_buffer, bytes);
+		buffer = codec->work_buffer;
+	}
 
 
 
 	input_rows = malloc(sizeof(unsigned char*) * height);
 	for(i = 0; i < height; i++)
-		input_rows[i] = codec->work_buffer + i * width * 4;
+		input_rows[i] = buffer + i * width * 4;
 
 	cmodel_transfer(row_pointers, 
 		input_rows,
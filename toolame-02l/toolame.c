@@ -50,7 +50,9 @@ void toolame_init_buffers()
 	toolame_eof = 0;
 }
 
-int toolame_send_buffer(char *data, int bytes)
+// Append bytes to the input buffer from either interleaved int16 data or
+// planar doubles.  Blocks until the encoder has room.
+static int send_data(char *data, double **samples, int channels, int bytes)
 {
 	int got_it = 0;
 	if(bytes > TOOLAME_BUFFER_BYTES)
@@ -82,7 +84,29 @@ int toolame_send_buffer(char *data, int bytes)
 
 		if(toolame_buffer_bytes < TOOLAME_BUFFER_BYTES - bytes)
 		{
-			memcpy(toolame_buffer + toolame_buffer_bytes, data, bytes);
+			if(samples)
+			{
+// Convert straight into the buffer
+				int len = bytes / channels / 2;
+				int i, j;
+				for(i = 0; i < channels; i++)
+				{
+					int16_t *output = (int16_t*)(toolame_buffer + 
+						toolame_buffer_bytes) + i;
+					double *input = samples[i];
+					for(j = 0; j < len; j++)
+					{
+						int sample = (int)(*input++ * 0x7fff);
+						if(sample > 0x7fff) sample = 0x7fff;
+						else
+						if(sample < -0x8000) sample = -0x8000;
+						*output = sample;
+						output += channels;
+					}
+				}
+			}
+			else
+				memcpy(toolame_buffer + toolame_buffer_bytes, data, bytes);
 			toolame_buffer_bytes += bytes;
 			got_it = 1;
 		}
@@ -92,6 +116,16 @@ int toolame_send_buffer(char *data, int bytes)
 	return 0;
 }
 
+int toolame_send_buffer(char *data, int bytes)
+{
+	return send_data(data, 0, 0, bytes);
+}
+
+int toolame_send_samples(double **samples, int channels, int len)
+{
+	return send_data(0, samples, channels, len * channels * 2);
+}
+
 int toolame_buffer_read(char *dst, int size, int n)
 {
 	int got_it = 0;